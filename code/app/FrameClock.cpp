@@ -0,0 +1,57 @@
+#include "app/FrameClock.h"
+#include <QDebug>
+
+FrameClock::FrameClock(QObject *parent)
+    : QObject(parent)
+    , m_timer(this) {
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(qRound(m_targetInterval));
+    connect(&m_timer, &QTimer::timeout, this, &FrameClock::tick);
+}
+
+void FrameClock::start() {
+    m_clock.start();
+    m_lastTickNs = m_clock.nsecsElapsed();
+    m_timer.start();
+}
+
+void FrameClock::stop() {
+    m_timer.stop();
+}
+
+void FrameClock::setRefreshRate(qreal refreshRate) {
+    if (refreshRate <= 0) refreshRate = 60.0;
+    refreshRate = qBound(MIN_REFRESH_RATE, refreshRate, MAX_REFRESH_RATE);
+    m_targetInterval = 1000.0 / refreshRate;
+    // 和原来一样每步最多1/60秒，低刷新率时一帧本来就更长，上限放宽到一帧
+    m_maxDeltaTime = qMax(1.0 / 60, m_targetInterval / 1000.0);
+    m_timer.setInterval(qRound(m_targetInterval));
+    qDebug() << "[FrameClock] 刷新率:" << refreshRate << "帧间隔(ms):" << m_timer.interval();
+}
+
+void FrameClock::tick() {
+    qint64 now = m_clock.nsecsElapsed();
+    double frameMs = (now - m_lastTickNs) / 1000000.0;
+    m_lastTickNs = now;
+    recordPacing(frameMs);
+    emit frame(qMin(frameMs / 1000.0, m_maxDeltaTime));
+}
+
+void FrameClock::recordPacing(double frameMs) {
+    double jitter = qAbs(frameMs - m_targetInterval);
+    m_statFrames++;
+    m_statTotalMs += frameMs;
+    m_statJitterSumMs += jitter;
+    m_statMaxJitterMs = qMax(m_statMaxJitterMs, jitter);
+    if (frameMs > m_targetInterval * 1.5) m_statLateFrames++; // 至少晚了半帧
+    if (m_statFrames < REPORT_FRAMES) return;
+    qDebug() << "[FrameClock] 平均帧间隔(ms):" << m_statTotalMs / m_statFrames
+             << "平均抖动(ms):" << m_statJitterSumMs / m_statFrames
+             << "最大抖动(ms):" << m_statMaxJitterMs
+             << "掉帧:" << m_statLateFrames << "/" << m_statFrames;
+    m_statFrames = 0;
+    m_statTotalMs = 0.0;
+    m_statJitterSumMs = 0.0;
+    m_statMaxJitterMs = 0.0;
+    m_statLateFrames = 0;
+}
@@ -3,22 +3,20 @@
 #include "view/AudioEventListener.h"
 #include "viewmodel/GameViewModel.h"
 #include "common/GameMap.h"
+#include <QWindow>
 #include <QDebug>
 
 Application::Application(int &argc, char **argv)
     : QApplication(argc, argv)
-    , m_gameTimer(this)
-    , m_frameTimer()
-    , m_deltaTime(0.0)
-    , m_lastFrameTime(0) {
+    , m_frameClock(this) {
     qDebug() << "Application starting up...";
     initalizeComponents();
     setupGameLoop();
 }
 
 void Application::initalizeComponents() {
-    AudioManager::instance().initialize();
-    GameMap::instance().loadFromFile(":/assert/picture/gamemap.json", "map_1", "1");
+    // 第一次访问关卡目录时解析gamemap.json里的全部布局，之后切换布局只换指针
+    GameMap::instance().loadLayout("map_1", "1");
     m_view = std::make_unique<MainWindow>();
     m_viewModel = std::make_unique<GameViewModel>(this);
     m_audioEventListener = std::make_unique<AudioEventListener>(this);
@@ -27,44 +25,47 @@ void Application::initalizeComponents() {
 
 
 void Application::setupGameLoop() {
-    
-    m_gameTimer.setInterval(FRAME_INTERVAL);
-    m_gameTimer.setTimerType(Qt::PreciseTimer);
     /*
-    QTimer: 闹钟，每隔FRAME_INTERVAL毫秒触发一次
-    QElapsedTimer: 用于测量时间间隔，
-        m_frameTimer->elapsed() - lastFrameTime才是真正的deltaTime
+    FrameClock: 每一帧发出一次frame信号，deltaTime已经限制过上限
+    以前逻辑和界面各有一个16ms的定时器，两者不同步会周期性地卡顿，现在合并成一个
     */
-    connect(&m_gameTimer, &QTimer::timeout, this, &Application::gameLoop);
+    connect(&m_frameClock, &FrameClock::frame, this, &Application::gameLoop);
+    // 第一帧之后排队初始化音频，等这一帧画到屏幕上再加载音频后端，启动到第一帧的时间不再包含这一步
+    connect(&m_frameClock, &FrameClock::frame, this, []() {
+        QMetaObject::invokeMethod(&AudioManager::instance(), []() {
+            AudioManager::instance().initialize();
+        }, Qt::QueuedConnection);
+    }, Qt::SingleShotConnection);
     connect(m_viewModel.get(), &GameViewModel::gameStateChanged, this, &Application::onGameStateChanged);
-
-    m_frameTimer.start();
-    m_lastFrameTime = m_frameTimer.elapsed();
 }
 
 int Application::run() {
     m_view->show();
-    m_gameTimer.start();
+    // 窗口创建之后才知道在哪块屏幕上
+    if (QWindow* window = m_view->windowHandle()) {
+        connect(window, &QWindow::screenChanged, this, &Application::onScreenChanged);
+        onScreenChanged(window->screen());
+    }
+    m_frameClock.start();
     return exec();
 }
 
-void Application::gameLoop() {
-    calculateDeltaTime();
-
+void Application::gameLoop(double deltaTime) {
+    // 一帧内的顺序：输入 → 逻辑 → 视图同步 → 渲染
+    GameWidget* gameWidget = m_view->getGameWidget();
+    gameWidget->processInput();
     if(m_viewModel) {
-        m_viewModel->updateGame(m_deltaTime);
+        m_viewModel->updateGame(deltaTime);
     }
-    processEvents();
+    gameWidget->updateView(deltaTime);
+    gameWidget->renderFrame();
 }
 
-void Application::calculateDeltaTime() {
-    qint64 currentTime = m_frameTimer.elapsed();
-    m_deltaTime = (currentTime - m_lastFrameTime) / 1000.0; 
-    m_lastFrameTime = currentTime;
-
-    if (m_deltaTime > 1.0 / TARGET_FPS) {
-        m_deltaTime = 1.0 / TARGET_FPS;
-    }
+void Application::onScreenChanged(QScreen *screen) {
+    disconnect(m_refreshRateConnection);
+    if (!screen) return;
+    m_frameClock.setRefreshRate(screen->refreshRate());
+    m_refreshRateConnection = connect(screen, &QScreen::refreshRateChanged, &m_frameClock, &FrameClock::setRefreshRate);
 }
 
 void Application::onGameStateChanged() {
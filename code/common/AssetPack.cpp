@@ -0,0 +1,127 @@
+#include "common/AssetPack.h"
+
+using namespace AssetPackFormat;
+
+AssetPack& AssetPack::instance() {
+    // 局部静态变量的初始化是线程安全的，关卡目录可能在工作线程里先访问到这里
+    static AssetPack instance;
+    return instance;
+}
+
+AssetPack::AssetPack() {
+    QString path = QCoreApplication::applicationDirPath() + "/assets.pack";
+    if (open(path)) {
+        qDebug() << "资源包映射完成:" << path << "大小:" << m_size << "字节";
+    } else {
+        qDebug() << "没有可用的资源包，从qrc加载资源:" << path;
+    }
+}
+
+AssetPack::~AssetPack() {
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+bool AssetPack::open(const QString& path) {
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(Header) + SectionCount * sizeof(Section))) return false;
+    uchar* data = m_file.map(0, m_size);
+    if (!data) {
+        qWarning() << "资源包映射失败:" << path;
+        return false;
+    }
+    m_data = data;
+    m_sections = reinterpret_cast<const Section*>(m_data + sizeof(Header));
+    if (!validate()) {
+        qWarning() << "资源包版本不对或者已经损坏，忽略:" << path;
+        m_file.unmap(data);
+        m_data = nullptr;
+        m_sections = nullptr;
+        return false;
+    }
+    buildFileIndex();
+    return true;
+}
+
+void AssetPack::buildFileIndex() {
+    // 文件名只在这里解码一次，之后按名字查文件是一次哈希查找
+    const PackArray<FileRecord> records = array<FileRecord>(Files);
+    m_fileIndex.reserve(records.count);
+    for (int index = 0; index < records.count; ++index) {
+        m_fileIndex.insert(string(records[index].name), index);
+    }
+}
+
+bool AssetPack::validate() const {
+    const Header* header = reinterpret_cast<const Header*>(m_data);
+    if (header->magic != MAGIC || header->version != VERSION || header->sectionCount != SectionCount) {
+        return false;
+    }
+    // 只检查段在文件范围内且对齐，记录内部的偏移在读取时再检查
+    for (int id = 0; id < SectionCount; ++id) {
+        const Section& section = m_sections[id];
+        if (section.offset % ALIGNMENT != 0) return false;
+        if (section.offset > static_cast<quint64>(m_size) || section.size > static_cast<quint64>(m_size) - section.offset) {
+            return false;
+        }
+    }
+    const Section& atlas = m_sections[Atlas];
+    if (atlas.size < sizeof(AtlasHeader)) return false;
+    const AtlasHeader* atlasHeader = reinterpret_cast<const AtlasHeader*>(m_data + atlas.offset);
+    return atlasHeader->format == QImage::Format_ARGB32_Premultiplied
+        && static_cast<quint64>(atlasHeader->bytesPerLine) * atlasHeader->height <= atlas.size - sizeof(AtlasHeader);
+}
+
+QString AssetPack::string(const StringRef& ref) const {
+    if (!m_data) return QString();
+    const Section& section = m_sections[Strings];
+    if (static_cast<quint64>(ref.offset) + ref.length > section.size) return QString();
+    return QString::fromUtf8(reinterpret_cast<const char*>(m_data + section.offset + ref.offset), ref.length);
+}
+
+PackArray<SpriteRecord> AssetPack::sprites() const {
+    return array<SpriteRecord>(Sprites);
+}
+
+PackArray<AnimationRecord> AssetPack::animations() const {
+    return array<AnimationRecord>(Animations);
+}
+
+PackArray<qint32> AssetPack::animationFrames() const {
+    return array<qint32>(AnimationFrames);
+}
+
+PackArray<LayoutRecord> AssetPack::layouts() const {
+    return array<LayoutRecord>(Layouts);
+}
+
+PackArray<LegendRecord> AssetPack::legendEntries() const {
+    return array<LegendRecord>(LegendEntries);
+}
+
+PackArray<qint32> AssetPack::tiles() const {
+    return array<qint32>(Tiles);
+}
+
+QImage AssetPack::atlas() const {
+    if (!m_data) return QImage();
+    const uchar* base = m_data + m_sections[Atlas].offset;
+    const AtlasHeader* header = reinterpret_cast<const AtlasHeader*>(base);
+    // const数据构造的QImage不会写回映射，需要修改时Qt会先拷贝一份
+    return QImage(base + sizeof(AtlasHeader), header->width, header->height, header->bytesPerLine,
+                  QImage::Format_ARGB32_Premultiplied);
+}
+
+QByteArray AssetPack::file(const QString& name) const {
+    if (!m_data) return QByteArray();
+    auto it = m_fileIndex.constFind(name);
+    if (it == m_fileIndex.constEnd()) return QByteArray();
+    const Section& data = m_sections[FileData];
+    const FileRecord& record = array<FileRecord>(Files)[it.value()];
+    if (record.offset > data.size || record.size > data.size - record.offset) return QByteArray();
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + data.offset + record.offset),
+                                   static_cast<qsizetype>(record.size));
+}
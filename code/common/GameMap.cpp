@@ -8,56 +8,28 @@ GameMap& GameMap::instance() {
     return instance;
 }
 
-bool GameMap::loadFromFile(const QString& path, const QString& mapName, const QString& layoutName) {
-    map_title = mapName + "_" + layoutName;
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "无法打开地图文件:" << path;
-        return false;
-    }
+bool GameMap::loadLayout(const QString& mapName, const QString& layoutName) {
+    return setLayout(LevelCatalog::instance().layout(mapName, layoutName));
+}
 
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
-    if (doc.isNull()) {
-        qWarning() << "解析地图文件失败:" << error.errorString();
+bool GameMap::setLayout(const MapLayout* layout) {
+    if (!layout) {
         return false;
     }
+    map_title = layout->mapName + "_" + layout->layoutName;
+    m_layout = layout;
+    m_width = layout->width;
+    m_height = layout->height;
 
-    QJsonObject root = doc.object();
+    buildClearanceMaps();
 
-    QJsonObject mapObject = root[mapName].toObject();
-    if (mapObject.isEmpty()) {
-        qWarning() << "在JSON中找不到名为" << mapName << "的地图对象";
-        return false;
-    }        
-    m_tiles.clear();
-    m_width = 0; 
-    m_height = 0;
-    QJsonArray layoutArray = mapObject[layoutName].toArray();
-    if (layoutArray.isEmpty()) {
-        qWarning() << "在地图" << mapName << "中找不到名为" << layoutName << "的布局，或者布局为空";
-        return false;
-    }
-    m_height = layoutArray.count();
-    for (const QJsonValue& rowVal : layoutArray) {
-        QList<int> row;
-        QJsonArray rowArray = rowVal.toArray();
-        if (m_height > 0 && m_width == 0) {
-            m_width = rowArray.count();
-        }
-        for (const QJsonValue& tileVal : rowArray) {
-            row.append(tileVal.toInt());
-        }
-        m_tiles.append(row);
-    }
-    
-    qDebug() << "地图" << mapName << "的布局" << layoutName << "加载成功，尺寸:" << m_width << "x" << m_height;
+    qDebug() << "地图" << layout->mapName << "的布局" << layout->layoutName << "加载成功，尺寸:" << m_width << "x" << m_height;
     return true;
 }
 
 bool GameMap::isWalkable(int row, int col) const{
-    return getTileIdAt(row, col) == 1 || getTileIdAt(row, col) == 3 || 
-           getTileIdAt(row, col) == 4 || getTileIdAt(row, col) == 5;
+    // 可行走的图块在关卡目录里已经算好
+    return m_layout && m_layout->isWalkable(row, col);
 }
 
 /*
@@ -68,14 +40,100 @@ bool GameMap::isWalkable(int row, int col) const{
     * 「1: 刷怪点, 2: , 3~5: 空地, 7: 地图边界」
 */
 int GameMap::getTileIdAt(int row, int col) const {
-    if (row < 0 || row >= m_height || col < 0 || col >= m_width) {
-        return 0; 
-    }
-    if(m_tiles[row][col] == 7) {
-        // qDebug() << "cannot pass position: " << row << col;
-    }
-    return m_tiles[row][col];
+    return m_layout ? m_layout->tileAt(row, col) : 0;
 }
 
 int GameMap::getWidth() const { return m_width; }
 int GameMap::getHeight() const { return m_height; }
+
+const ClearanceMap* GameMap::getClearanceMap(int size) const {
+    for (const ClearanceMap& map : m_clearanceMaps) {
+        if (map.size == size) {
+            return &map;
+        }
+    }
+    return nullptr;
+}
+
+/*
+    * 与CollisionSystem::isRectCollidingWithMap相同的逐瓦片判定，只用于预计算
+    * @param px, py 方块左上角像素坐标
+    * @return 方块覆盖到不可行走瓦片时返回true
+*/
+bool GameMap::isRectBlocked(int px, int py, int size) const {
+    int row1 = static_cast<int>(py / 16.0);
+    int col1 = static_cast<int>(px / 16.0);
+    int row2 = static_cast<int>((py + size - 1) / 16.0);
+    int col2 = static_cast<int>((px + size - 1) / 16.0);
+
+    for (int r = row1; r <= row2; ++r) {
+        for (int c = col1; c <= col2; ++c) {
+            if (!isWalkable(r, c)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*
+    * 布局加载后为每个尺寸重建通行图
+    * 覆盖范围向左上多留15像素，保证贴边生成的敌人也能查表
+    * （再往外截断取整的结果和按像素取整不一致，交给逐瓦片检测）
+*/
+void GameMap::buildClearanceMaps() {
+    m_clearanceMaps.clear();
+    for (int size : CLEARANCE_SIZES) {
+        ClearanceMap map;
+        map.size = size;
+        map.originX = -15;
+        map.originY = -15;
+        map.width = m_width * 16 + 15;
+        map.height = m_height * 16 + 15;
+        const int count = map.width * map.height;
+        map.runLeft.fill(-1, count);
+        map.runRight.fill(-1, count);
+        map.runUp.fill(-1, count);
+        map.runDown.fill(-1, count);
+
+        for (int y = 0; y < map.height; ++y) {
+            for (int x = 0; x < map.width; ++x) {
+                if (!isRectBlocked(x + map.originX, y + map.originY, size)) {
+                    map.runLeft[y * map.width + x] = 0;
+                }
+            }
+        }
+
+        // 横向连续可容纳的像素数
+        for (int y = 0; y < map.height; ++y) {
+            const int row = y * map.width;
+            for (int x = 1; x < map.width; ++x) {
+                if (map.runLeft[row + x] >= 0 && map.runLeft[row + x - 1] >= 0) {
+                    map.runLeft[row + x] = map.runLeft[row + x - 1] + 1;
+                }
+            }
+            for (int x = map.width - 1; x >= 0; --x) {
+                if (map.runLeft[row + x] < 0) continue;
+                map.runRight[row + x] = (x + 1 < map.width && map.runRight[row + x + 1] >= 0)
+                                        ? map.runRight[row + x + 1] + 1 : 0;
+            }
+        }
+
+        // 纵向连续可容纳的像素数
+        for (int x = 0; x < map.width; ++x) {
+            for (int y = 0; y < map.height; ++y) {
+                const int i = y * map.width + x;
+                if (map.runLeft[i] < 0) continue;
+                map.runUp[i] = (y > 0 && map.runUp[i - map.width] >= 0) ? map.runUp[i - map.width] + 1 : 0;
+            }
+            for (int y = map.height - 1; y >= 0; --y) {
+                const int i = y * map.width + x;
+                if (map.runLeft[i] < 0) continue;
+                map.runDown[i] = (y + 1 < map.height && map.runDown[i + map.width] >= 0)
+                                 ? map.runDown[i + map.width] + 1 : 0;
+            }
+        }
+
+        m_clearanceMaps.append(map);
+    }
+}
@@ -0,0 +1,122 @@
+#include "common/LevelCatalog.h"
+
+LevelCatalog& LevelCatalog::instance() {
+    // 局部静态变量的初始化是线程安全的，第一次访问的线程负责解析
+    static LevelCatalog instance;
+    return instance;
+}
+
+LevelCatalog::LevelCatalog() {
+    if (!loadFromPack(AssetPack::instance())) {
+        loadFromFile(":/assert/picture/gamemap.json");
+    }
+}
+
+const MapLayout* LevelCatalog::layout(const QString& mapName, const QString& layoutName) const {
+    auto it = m_layouts.constFind(key(mapName, layoutName));
+    if (it == m_layouts.constEnd()) {
+        qWarning() << "在地图" << mapName << "中找不到名为" << layoutName << "的布局，或者布局为空";
+        return nullptr;
+    }
+    return &it.value();
+}
+
+bool LevelCatalog::loadFromFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开地图文件:" << path;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (doc.isNull()) {
+        qWarning() << "解析地图文件失败:" << error.errorString();
+        return false;
+    }
+
+    // 每张地图里除了tile_definitions，其余的键都是布局名
+    QJsonObject root = doc.object();
+    for (auto mapIt = root.begin(); mapIt != root.end(); ++mapIt) {
+        QJsonObject mapObject = mapIt.value().toObject();
+        if (!mapObject.contains("tile_definitions")) continue;
+        QMap<int, QString> legend;
+        QJsonObject legendObject = mapObject["tile_definitions"].toObject();
+        for (auto it = legendObject.begin(); it != legendObject.end(); ++it) {
+            legend[it.key().toInt()] = it.value().toString();
+        }
+        for (auto layoutIt = mapObject.begin(); layoutIt != mapObject.end(); ++layoutIt) {
+            if (layoutIt.key() == "tile_definitions") continue;
+            MapLayout layout = parseLayout(mapIt.key(), layoutIt.key(), legend, layoutIt.value().toArray());
+            if (layout.isValid()) {
+                m_layouts.insert(key(mapIt.key(), layoutIt.key()), layout);
+            }
+        }
+    }
+    qDebug() << "关卡目录加载完成，布局数量:" << m_layouts.size();
+    return true;
+}
+
+bool LevelCatalog::loadFromPack(const AssetPack& pack) {
+    if (!pack.isOpen()) return false;
+    const PackArray<qint32> tiles = pack.tiles();
+    const PackArray<AssetPackFormat::LegendRecord> legendEntries = pack.legendEntries();
+    for (const AssetPackFormat::LayoutRecord& record : pack.layouts()) {
+        const int tileCount = record.width * record.height;
+        if (record.firstTile < 0 || tileCount <= 0 || record.firstTile + tileCount > tiles.count) continue;
+        if (record.firstLegend < 0 || record.firstLegend + record.legendCount > legendEntries.count) continue;
+        MapLayout layout;
+        layout.mapName = pack.string(record.mapName);
+        layout.layoutName = pack.string(record.layoutName);
+        layout.width = record.width;
+        layout.height = record.height;
+        for (int i = 0; i < record.legendCount; ++i) {
+            const AssetPackFormat::LegendRecord& entry = legendEntries[record.firstLegend + i];
+            layout.legend[entry.tileId] = pack.string(entry.spriteName);
+        }
+        layout.tiles = QVector<int>(tiles.begin() + record.firstTile, tiles.begin() + record.firstTile + tileCount);
+        buildDerivedData(layout);
+        m_layouts.insert(key(layout.mapName, layout.layoutName), layout);
+    }
+    if (m_layouts.isEmpty()) return false;
+    qDebug() << "关卡目录从资源包加载完成，布局数量:" << m_layouts.size();
+    return true;
+}
+
+MapLayout LevelCatalog::parseLayout(const QString& mapName, const QString& layoutName,
+                                    const QMap<int, QString>& legend, const QJsonArray& layoutArray) {
+    MapLayout layout;
+    layout.mapName = mapName;
+    layout.layoutName = layoutName;
+    layout.legend = legend;
+    if (layoutArray.isEmpty()) return layout;
+
+    // 宽度以第一行为准，短的行补0，长的行截断
+    layout.width = layoutArray[0].toArray().count();
+    layout.height = layoutArray.count();
+    layout.tiles.fill(0, layout.width * layout.height);
+    for (int row = 0; row < layout.height; ++row) {
+        QJsonArray rowArray = layoutArray[row].toArray();
+        for (int col = 0; col < layout.width && col < rowArray.count(); ++col) {
+            layout.tiles[row * layout.width + col] = rowArray[col].toInt();
+        }
+    }
+    buildDerivedData(layout);
+    return layout;
+}
+
+void LevelCatalog::buildDerivedData(MapLayout& layout) {
+    layout.walkable.fill(0, layout.width * layout.height);
+    layout.spawnTiles.clear();
+    layout.tilesBySprite.clear();
+    for (int row = 0; row < layout.height; ++row) {
+        for (int col = 0; col < layout.width; ++col) {
+            int index = row * layout.width + col;
+            int tileId = layout.tiles[index];
+            // 「1: 刷怪点, 2: , 3~5: 空地, 7: 地图边界」
+            layout.walkable[index] = (tileId == 1 || tileId == 3 || tileId == 4 || tileId == 5) ? 1 : 0;
+            if (tileId == 1) layout.spawnTiles.append(QPoint(col, row));
+            layout.tilesBySprite[layout.legend.value(tileId, "empty")].append(QPoint(col, row));
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include "common/TimerWheel.h"
+#include <cmath>
+
+TimerWheel::TimerWheel() {
+}
+
+qint64 TimerWheel::expiryTickFor(double seconds) {
+    // 减去一点余量，避免浮点误差把正好落在tick上的时间推到下一个tick
+    return static_cast<qint64>(std::ceil(seconds * TICKS_PER_SECOND - 1e-6));
+}
+
+qint64 TimerWheel::tickAt(double seconds) {
+    return static_cast<qint64>(std::floor(seconds * TICKS_PER_SECOND + 1e-6));
+}
+
+void TimerWheel::schedule(int key, qint64 expiryTick) {
+    cancel(key);
+    // 已经过期的放到下一个tick处理
+    expiryTick = std::max(expiryTick, m_currentTick + 1);
+
+    int node;
+    if (!m_freeNodes.isEmpty()) {
+        node = m_freeNodes.takeLast();
+        m_nodes[node] = {key, expiryTick, true};
+    } else {
+        node = m_nodes.size();
+        m_nodes.append({key, expiryTick, true});
+    }
+    m_nodeOfKey.insert(key, node);
+    insertNode(node);
+}
+
+void TimerWheel::cancel(int key) {
+    auto it = m_nodeOfKey.find(key);
+    if (it == m_nodeOfKey.end()) {
+        return;
+    }
+    // 懒删除：节点留在格子里，转到时再回收
+    m_nodes[it.value()].live = false;
+    m_nodeOfKey.erase(it);
+}
+
+void TimerWheel::insertNode(int node) {
+    qint64 expiry = m_nodes[node].expiry;
+    if (expiry - m_currentTick < LEVEL0_SLOTS) {
+        m_level0[expiry % LEVEL0_SLOTS].append(node);
+        return;
+    }
+    qint64 block = expiry / LEVEL0_SLOTS;
+    qint64 currentBlock = m_currentTick / LEVEL0_SLOTS;
+    if (block - currentBlock >= LEVEL1_SLOTS) {
+        block = currentBlock + LEVEL1_SLOTS - 1;
+    }
+    m_level1[block % LEVEL1_SLOTS].append(node);
+}
+
+void TimerWheel::cascade() {
+    // 第1级当前格子里的节点都在接下来的256个tick内到期（或者超出范围需要重新挂）
+    QVector<int>& slot = m_level1[(m_currentTick / LEVEL0_SLOTS) % LEVEL1_SLOTS];
+    m_firing.swap(slot);
+    for (int node : m_firing) {
+        if (m_nodes[node].live) {
+            insertNode(node);
+        } else {
+            releaseNode(node);
+        }
+    }
+    m_firing.clear();
+}
+
+void TimerWheel::advanceTo(qint64 tick, QVector<int>& expiredKeys) {
+    while (m_currentTick < tick) {
+        ++m_currentTick;
+        if (m_currentTick % LEVEL0_SLOTS == 0) {
+            cascade();
+        }
+
+        QVector<int>& slot = m_level0[m_currentTick % LEVEL0_SLOTS];
+        if (slot.isEmpty()) {
+            continue;
+        }
+        m_firing.swap(slot);
+        for (int node : m_firing) {
+            Node& n = m_nodes[node];
+            if (!n.live) {
+                releaseNode(node);
+            } else if (n.expiry <= m_currentTick) {
+                expiredKeys.append(n.key);
+                m_nodeOfKey.remove(n.key);
+                releaseNode(node);
+            } else {
+                insertNode(node);
+            }
+        }
+        m_firing.clear();
+    }
+}
+
+void TimerWheel::releaseNode(int node) {
+    m_nodes[node].live = false;
+    m_freeNodes.append(node);
+}
+
+void TimerWheel::clear(qint64 tick) {
+    for (QVector<int>& slot : m_level0) slot.clear();
+    for (QVector<int>& slot : m_level1) slot.clear();
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_nodeOfKey.clear();
+    m_currentTick = tick;
+}
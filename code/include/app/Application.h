@@ -5,6 +5,7 @@
 #include <viewmodel/GameViewModel.h>
 #include <view/AudioEventListener.h>
 #include <app/GameService.h>
+#include <app/FrameClock.h>
 
 
 class Application: public QApplication {
@@ -16,12 +17,12 @@ public:
     int run();
 
 private slots:
-    void gameLoop();
+    void gameLoop(double deltaTime);
     void onGameStateChanged();
+    void onScreenChanged(QScreen *screen);
 
 private:
     void setupGameLoop();
-    void calculateDeltaTime();
     void initalizeComponents();
     /*
      * 由于Application类继承自QApplication，不能够使用connect
@@ -33,12 +34,7 @@ private:
     std::unique_ptr<GameService> m_service;
     std::unique_ptr<AudioEventListener> m_audioEventListener;
 
-    QTimer m_gameTimer;
-    QElapsedTimer m_frameTimer;
-    double m_deltaTime;
-    qint64 m_lastFrameTime;
-
-    static const int TARGET_FPS = 60; 
-    static const int FRAME_INTERVAL = 1000 / TARGET_FPS;
+    FrameClock m_frameClock; // 唯一的帧时钟，输入、逻辑、视图和渲染都由它驱动
+    QMetaObject::Connection m_refreshRateConnection;
 };
 #endif
\ No newline at end of file
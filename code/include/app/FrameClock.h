@@ -0,0 +1,47 @@
+#ifndef __FRAME_CLOCK_H__
+#define __FRAME_CLOCK_H__
+
+/*
+ * 全局唯一的帧时钟
+ * 每个tick发出一次frame信号，由Application按 输入 → 逻辑 → 视图同步 → 渲染 的顺序处理一帧
+ * 帧间隔跟随显示器刷新率，统计实际帧间隔和目标间隔的偏差，定期输出日志
+ */
+class FrameClock : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FrameClock(QObject *parent = nullptr);
+    void start();
+    void stop();
+    // 按显示器刷新率调整帧间隔
+    void setRefreshRate(qreal refreshRate);
+    double targetInterval() const { return m_targetInterval; }
+
+signals:
+    void frame(double deltaTime);
+
+private slots:
+    void tick();
+
+private:
+    void recordPacing(double frameMs);
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastTickNs = 0;
+    double m_targetInterval = 1000.0 / 60; // 毫秒
+    double m_maxDeltaTime = 1.0 / 60;       // 单帧最多推进的秒数，卡顿后不会一下跳太远
+
+    // 抖动统计，每REPORT_FRAMES帧输出一次
+    int m_statFrames = 0;
+    double m_statTotalMs = 0.0;
+    double m_statMaxJitterMs = 0.0;
+    double m_statJitterSumMs = 0.0;
+    int m_statLateFrames = 0;
+
+    static constexpr qreal MIN_REFRESH_RATE = 30.0;
+    static constexpr qreal MAX_REFRESH_RATE = 240.0;
+    static constexpr int REPORT_FRAMES = 600;
+};
+
+#endif
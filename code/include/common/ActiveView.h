@@ -0,0 +1,66 @@
+#ifndef __ACTIVE_VIEW_H__
+#define __ACTIVE_VIEW_H__
+
+/*
+    * 活动实体的只读视图
+    * 不拷贝数据，直接遍历底层存储并跳过 isActive 为 false 的元素
+    * 视图只保存指针，读取时看到的总是存储的最新状态，存储对象本身销毁后视图失效
+    * 两种存储：
+    *   - 对象池：base[indices[0 .. *count)]，子弹池使用
+    *   - QList：list[0 .. size)，道具列表使用
+*/
+template <typename T>
+class ActiveView {
+public:
+    ActiveView() = default;
+    ActiveView(const T* base, const int* indices, const int* count)
+        : m_base(base), m_indices(indices), m_count(count) {}
+    explicit ActiveView(const QList<T>* list)
+        : m_list(list) {}
+
+    class const_iterator {
+    public:
+        const_iterator(const ActiveView* view, int pos) : m_view(view), m_pos(pos) { skipInactive(); }
+        const T& operator*() const { return m_view->rawAt(m_pos); }
+        const T* operator->() const { return &m_view->rawAt(m_pos); }
+        const_iterator& operator++() { ++m_pos; skipInactive(); return *this; }
+        // 遍历过程中存储变短时，越界的位置都算作末尾
+        bool operator==(const const_iterator& other) const {
+            return atEnd() ? other.atEnd() : m_pos == other.m_pos;
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    private:
+        bool atEnd() const { return m_pos >= m_view->rawSize(); }
+        void skipInactive() {
+            while (!atEnd() && !m_view->rawAt(m_pos).isActive) ++m_pos;
+        }
+        const ActiveView* m_view;
+        int m_pos;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, rawSize()); }
+    bool isEmpty() const { return begin() == end(); }
+    // 活动元素个数，需要遍历一次
+    int count() const {
+        int n = 0;
+        for (auto it = begin(); it != end(); ++it) ++n;
+        return n;
+    }
+
+private:
+    int rawSize() const {
+        if (m_indices) return *m_count;
+        return m_list ? static_cast<int>(m_list->size()) : 0;
+    }
+    const T& rawAt(int pos) const {
+        return m_indices ? m_base[m_indices[pos]] : m_list->at(pos);
+    }
+
+    const T* m_base = nullptr;
+    const int* m_indices = nullptr;
+    const int* m_count = nullptr;
+    const QList<T>* m_list = nullptr;
+};
+
+#endif
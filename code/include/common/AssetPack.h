@@ -0,0 +1,155 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <QImage>
+#include <QByteArray>
+#include <QHash>
+
+/*
+    * 二进制资源包的文件格式
+    * 构建时由AssetPacker把sprite.json、sprite.png、gamemap.json和音效打成一个assets.pack，
+    * 运行时整个文件内存映射，下面这些记录直接在映射的内存上读，不做解析和拷贝
+    * 所有整数按本机字节序存放，每个段按16字节对齐；字符串统一放在Strings段里，记录里只存偏移和长度
+*/
+namespace AssetPackFormat {
+
+constexpr quint32 MAGIC = 0x4B50444D;   // "MDPK"，字节序不同时读出来对不上，直接回退到qrc
+constexpr quint32 VERSION = 1;          // 格式有任何改动都要加一
+constexpr int ALIGNMENT = 16;
+
+enum SectionId : quint32 {
+    Strings = 0,     // UTF-8字符串池
+    Sprites,         // SpriteRecord[]，复合精灵已经合成好
+    Animations,      // AnimationRecord[]
+    AnimationFrames, // qint32[]，动画帧ID
+    Atlas,           // AtlasHeader，后面紧跟像素
+    Layouts,         // LayoutRecord[]
+    LegendEntries,   // LegendRecord[]
+    Tiles,           // qint32[]，所有布局的图块按行连续存放
+    Files,           // FileRecord[]
+    FileData,        // 原样存放的文件内容
+    SectionCount
+};
+
+struct Header {
+    quint32 magic;
+    quint32 version;
+    quint32 sectionCount;
+    quint32 reserved;
+};
+
+struct Section {
+    quint64 offset;  // 相对文件开头
+    quint64 size;    // 字节数
+};
+
+struct StringRef {
+    quint32 offset;  // 相对Strings段开头
+    quint32 length;  // UTF-8字节数
+};
+
+struct SpriteRecord {
+    StringRef name;
+    qint32 x, y, width, height;   // 在合成后的精灵表里的源矩形
+    qint32 originX, originY;      // 相对绘制位置的偏移
+};
+
+struct AnimationRecord {
+    StringRef name;
+    qint32 firstFrame;  // AnimationFrames里的起始下标
+    qint32 frameCount;
+};
+
+struct AtlasHeader {
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    qint32 format;      // QImage::Format，固定为Format_ARGB32_Premultiplied
+};
+
+struct LayoutRecord {
+    StringRef mapName;
+    StringRef layoutName;
+    qint32 width, height;
+    qint32 firstTile;    // Tiles里的起始下标
+    qint32 firstLegend;  // LegendEntries里的起始下标
+    qint32 legendCount;
+    qint32 reserved;
+};
+
+struct LegendRecord {
+    qint32 tileId;
+    StringRef spriteName;
+};
+
+struct FileRecord {
+    StringRef name;      // 相对assert目录的路径，比如"sound/cowboy_dead.wav"
+    quint64 offset;      // 相对FileData段开头
+    quint64 size;
+};
+
+} // namespace AssetPackFormat
+
+// 指向映射内存里一段连续记录的只读区间
+template <typename T>
+struct PackArray {
+    const T* first = nullptr;
+    int count = 0;
+    const T* begin() const { return first; }
+    const T* end() const { return first + count; }
+    const T& operator[](int index) const { return first[index]; }
+    bool isEmpty() const { return count == 0; }
+};
+
+/*
+    * 运行时的资源包
+    * 第一次访问时找可执行文件旁边的assets.pack并整个映射进来，校验失败就当作没有资源包
+    * 没有资源包时各个模块照旧从qrc里读JSON和PNG，所以不跑打包步骤也能启动
+    * 映射在程序运行期间一直有效，返回的区间、图片和字节数组都直接指向映射的内存
+*/
+class AssetPack {
+public:
+    static AssetPack& instance();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    QString string(const AssetPackFormat::StringRef& ref) const;
+    PackArray<AssetPackFormat::SpriteRecord> sprites() const;
+    PackArray<AssetPackFormat::AnimationRecord> animations() const;
+    PackArray<qint32> animationFrames() const;
+    PackArray<AssetPackFormat::LayoutRecord> layouts() const;
+    PackArray<AssetPackFormat::LegendRecord> legendEntries() const;
+    PackArray<qint32> tiles() const;
+
+    // 合成好的精灵表，不拷贝像素
+    QImage atlas() const;
+    // 按相对assert目录的路径取文件内容，没有时返回空数组
+    QByteArray file(const QString& name) const;
+
+private:
+    AssetPack();
+    ~AssetPack();
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const QString& path);
+    bool validate() const;
+    void buildFileIndex();
+    template <typename T>
+    PackArray<T> array(AssetPackFormat::SectionId id) const {
+        PackArray<T> result;
+        if (!m_data) return result;
+        const AssetPackFormat::Section& section = m_sections[id];
+        result.first = reinterpret_cast<const T*>(m_data + section.offset);
+        result.count = static_cast<int>(section.size / sizeof(T));
+        return result;
+    }
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    const AssetPackFormat::Section* m_sections = nullptr;
+    QHash<QString, int> m_fileIndex;  // 文件名到FileRecord下标，映射时建一次
+};
+
+#endif // ASSETPACK_H
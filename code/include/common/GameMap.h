@@ -1,23 +1,57 @@
 #ifndef __GAME_MAP_H__
 #define __GAME_MAP_H__
 
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QVector>
+#include "common/LevelCatalog.h"
+
+/*
+    * 某一尺寸方块的通行图（按像素）
+    * 对每个像素位置记录方块左上角放在这里时能否容纳，
+    * 以及从这里沿四个方向还能连续移动多少像素；-1 表示放不下
+*/
+struct ClearanceMap {
+    int size = 0;
+    int originX = 0;   // 第0列对应的像素坐标
+    int originY = 0;
+    int width = 0;     // 覆盖的像素列数
+    int height = 0;    // 覆盖的像素行数
+    QVector<qint16> runLeft;
+    QVector<qint16> runRight;
+    QVector<qint16> runUp;
+    QVector<qint16> runDown;
+
+    bool contains(int px, int py) const {
+        return px >= originX && px < originX + width && py >= originY && py < originY + height;
+    }
+    int indexOf(int px, int py) const { return (py - originY) * width + (px - originX); }
+    bool fits(int index) const { return runLeft[index] >= 0; }
+};
 
 class GameMap {
 public:
     GameMap();
     static GameMap& instance();
     ~GameMap() {}
-    bool loadFromFile(const QString& path, const QString& mapName, const QString& layoutName);
+    // 从LevelCatalog取布局
+    bool loadLayout(const QString& mapName, const QString& layoutName);
+    // 换成目录里的另一个布局，只重建通行图；不碰其他单例，可以在工作线程里对非单例对象调用
+    bool setLayout(const MapLayout* layout);
+    const MapLayout* layout() const { return m_layout; }
     bool isWalkable(int row, int col) const;
     int getTileIdAt(int row, int col) const;
     int getWidth() const;
     int getHeight() const;
+    // 获取预计算的通行图，未预计算的尺寸返回nullptr
+    const ClearanceMap* getClearanceMap(int size) const;
+
+    // 需要预计算通行图的方块尺寸：玩家14，敌人16
+    static constexpr int CLEARANCE_SIZES[] = {14, 16};
 private:
-    QList<QList<int>> m_tiles;       // 存储地图布局的二维列表
-    QMap<int, QString> m_tileLegend; // 存储图块ID到精灵名字的映射
+    void buildClearanceMaps();
+    bool isRectBlocked(int px, int py, int size) const;
+
+    QList<ClearanceMap> m_clearanceMaps;
+    const MapLayout* m_layout = nullptr; // 指向LevelCatalog里的布局
     QString map_title;
     int m_width;
     int m_height;
@@ -0,0 +1,64 @@
+#ifndef LEVELCATALOG_H
+#define LEVELCATALOG_H
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QVector>
+#include <QPoint>
+#include "common/AssetPack.h"
+
+/*
+    * gamemap.json里的一个布局，解析后不再修改，逻辑层和视图层共用同一份
+    * 图块按行连续存放，可行走、刷怪点和按精灵名分组的图块位置都在解析时算好
+*/
+struct MapLayout {
+    QString mapName;
+    QString layoutName;
+    int width = 0;
+    int height = 0;
+    QVector<int> tiles;                          // tiles[row * width + col]
+    QVector<quint8> walkable;                    // 和tiles一一对应
+    QVector<QPoint> spawnTiles;                  // 刷怪点图块，x为列，y为行
+    QMap<int, QString> legend;                   // 图块ID -> 精灵名字
+    QMap<QString, QVector<QPoint>> tilesBySprite; // 精灵名字 -> 用到它的图块位置，视图据此找动画图块
+
+    bool isValid() const { return height > 0; }
+    bool contains(int row, int col) const { return row >= 0 && row < height && col >= 0 && col < width; }
+    int tileAt(int row, int col) const { return contains(row, col) ? tiles[row * width + col] : 0; }
+    bool isWalkable(int row, int col) const { return contains(row, col) && walkable[row * width + col]; }
+};
+
+/*
+    * 关卡目录
+    * 第一次访问时把所有地图的所有布局一次性加载好，之后只读
+    * 有资源包时直接读打包好的图块数组，没有时解析qrc里的gamemap.json
+    * 切换布局时逻辑层和视图层都只是换一个指向目录里布局的指针，指针在程序运行期间一直有效
+    * 加载完成后不再修改，工作线程也可以直接读
+*/
+class LevelCatalog {
+public:
+    static LevelCatalog& instance();
+
+    // 找不到时返回nullptr
+    const MapLayout* layout(const QString& mapName, const QString& layoutName) const;
+    int layoutCount() const { return m_layouts.size(); }
+
+private:
+    LevelCatalog();
+    ~LevelCatalog() = default;
+    LevelCatalog(const LevelCatalog&) = delete;
+    LevelCatalog& operator=(const LevelCatalog&) = delete;
+
+    bool loadFromFile(const QString& path);
+    bool loadFromPack(const AssetPack& pack);
+    static MapLayout parseLayout(const QString& mapName, const QString& layoutName,
+                                 const QMap<int, QString>& legend, const QJsonArray& layoutArray);
+    // 根据图块算出可行走、刷怪点和按精灵分组的位置，两种加载方式共用
+    static void buildDerivedData(MapLayout& layout);
+    static QString key(const QString& mapName, const QString& layoutName) { return mapName + "/" + layoutName; }
+
+    QHash<QString, MapLayout> m_layouts;   // 加载后不再插入，元素地址不变
+};
+
+#endif // LEVELCATALOG_H
@@ -0,0 +1,54 @@
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <QVector>
+#include <QHash>
+
+/*
+    * 两级分层时间轮，按整数tick调度到期事件
+    * 第0级256格每格1个tick，第1级64格每格256个tick，超出范围的挂在第1级最远的格子里，转到时再重新分配
+    * 每次推进只处理走过的格子，调度、取消和到期都是均摊O(1)
+    * key由调用方决定（效果类型、道具id等），同一个key重复调度会覆盖之前的到期时间
+*/
+class TimerWheel {
+public:
+    static constexpr int TICKS_PER_SECOND = 60;
+    static constexpr int LEVEL0_SLOTS = 256;
+    static constexpr int LEVEL1_SLOTS = 64;
+
+    TimerWheel();
+
+    void schedule(int key, qint64 expiryTick);
+    void cancel(int key);
+    bool isScheduled(int key) const { return m_nodeOfKey.contains(key); }
+    // 推进到指定tick，把到期的key追加到expiredKeys（按到期先后）
+    void advanceTo(qint64 tick, QVector<int>& expiredKeys);
+    void clear(qint64 tick = 0);
+    qint64 currentTick() const { return m_currentTick; }
+    int size() const { return m_nodeOfKey.size(); }
+
+    // 秒与tick的换算：到期时间向上取整，当前时间向下取整，保证不会提前到期
+    static qint64 expiryTickFor(double seconds);
+    static qint64 tickAt(double seconds);
+
+private:
+    struct Node {
+        int key;
+        qint64 expiry;
+        bool live;
+    };
+
+    void insertNode(int node);
+    void cascade();
+    void releaseNode(int node);
+
+    QVector<Node> m_nodes;
+    QVector<int> m_freeNodes;
+    QHash<int, int> m_nodeOfKey;            // key -> 节点下标
+    QVector<int> m_level0[LEVEL0_SLOTS];
+    QVector<int> m_level1[LEVEL1_SLOTS];
+    QVector<int> m_firing;                  // 正在处理的格子，复用避免每个tick分配
+    qint64 m_currentTick = 0;
+};
+
+#endif
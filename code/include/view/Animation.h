@@ -1,21 +1,26 @@
 #ifndef ANIMATION_H
 #define ANIMATION_H
+#include "view/SpriteManager.h"
 
+/*
+    * 动画播放头
+    * 帧列表、帧率和循环方式都在共享的AnimationClip里，这里只记录播放进度
+    * 值类型，不占用堆内存，可以直接放在实体里
+*/
 class Animation {
 public:
-    Animation(const QList<QString>& frameNames, double frameRate = 10.0, bool loops = true);
+    explicit Animation(const AnimationClip* clip = nullptr);
+    void setClip(const AnimationClip* clip); // 换片段，从头播放
+    const AnimationClip* clip() const { return m_clip; }
     void update(double deltaTime);
-    const QString& getCurrentFrameName() const;
+    int getCurrentFrame() const; // 当前帧的精灵ID
     void reset();
     bool isFinished() const;
 
 private:
-    QList<QString> m_frameNames; 
-
-    bool m_loops;                 
-    double m_frameDuration;       
+    const AnimationClip* m_clip;
     double m_elapsedTime;         
     int m_currentIndex;           
 };
 
-#endif // ANIMATION_H
\ No newline at end of file
+#endif // ANIMATION_H
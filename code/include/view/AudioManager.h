@@ -31,7 +31,13 @@ enum MusicType {
     UNDEAD
 };
 
-// 音频管理器 - 单例模式，负责管理游戏中的所有音频资源
+/*
+    * 音频管理器 - 单例模式，负责管理游戏中的所有音频资源
+    * 构造时不碰音频后端，第一帧画出来之后才在GUI线程上初始化
+    * QMediaDevices和播放器都不是线程安全的，后端和播放器都在GUI线程上创建
+    * 初始化完成前的音效直接丢弃，请求的背景音乐记下来，初始化完成后再开始播放
+    * 每种音效的播放器在第一次播放时才创建
+*/
 class AudioManager : public QObject
 {
     Q_OBJECT
@@ -44,8 +50,9 @@ public:
     AudioManager(const AudioManager&) = delete;
     AudioManager& operator=(const AudioManager&) = delete;
 
-    // 初始化音频系统
+    // 初始化音频系统，只创建背景音乐播放器；第一次调用时会加载音频后端，必须在GUI线程上调用
     bool initialize();
+    bool isReady() const { return m_ready; }
 
     // 音效控制
     void playSound(SoundType type);                    // 播放指定类型音效
@@ -91,20 +98,26 @@ private:
     explicit AudioManager(QObject *parent = nullptr);
     ~AudioManager();
 
-    // 加载音效和音乐
-    void loadSoundEffects();                           // 加载所有音效文件
-    void loadMusic();                                  // 加载背景音乐文件
+    // 第一次播放时打开音效，找不到文件时返回nullptr
+    struct SoundPlayer;
+    std::shared_ptr<SoundPlayer> openSound(SoundType type);
 
     // 获取资源路径
     QString getSoundPath(SoundType type) const;        // 获取音效文件路径
     QString getMusicPath(MusicType type) const;        // 获取背景音乐文件路径
+    void setPlayerSource(QMediaPlayer* player, const QString& path, const QByteArray& packData); // 资源包里有就播放映射的内存，否则读磁盘
 
     // 音效播放器管理 - 使用QMediaPlayer替代QSoundEffect
     struct SoundPlayer {
         std::shared_ptr<QMediaPlayer> player;          // 媒体播放器
         std::shared_ptr<QAudioOutput> output;          // 音频输出
     };
-    QMap<SoundType, std::shared_ptr<SoundPlayer>> m_soundPlayers; // 音效播放器映射
+    QMap<SoundType, std::shared_ptr<SoundPlayer>> m_soundPlayers; // 音效播放器映射，打开失败的存nullptr，不再重试
+    QMap<SoundType, int> m_soundTypeVolumes;           // 单独设置过的音效音量，打开播放器时使用
+
+    // 初始化状态
+    bool m_ready = false;                              // 背景音乐播放器是否已创建
+    bool m_musicPending = false;                       // 初始化完成前请求过背景音乐
 
     // 背景音乐播放器
     std::shared_ptr<QMediaPlayer> m_musicPlayer;       // 背景音乐播放器
@@ -0,0 +1,69 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include "view/SpriteAtlas.h"
+
+// 绘制层，从下往上
+enum class DrawLayer {
+    Map,
+    Corpse,
+    Vendor,
+    Item,
+    Player,
+    HeldItem,   // 玩家举起的道具
+    Monster,
+    Bullet,
+    Effect,
+    Ui,
+    Count
+};
+
+struct DrawCommand {
+    int spriteId;
+    qreal x;        // 左上角，画布坐标
+    qreal y;
+    qreal scale;    // 缩放，只有手持道具的图标不是1
+    DrawLayer layer;
+    QRect source;   // 精灵表上的源矩形，追加时解析好，渲染线程不用再查SpriteManager
+};
+
+/*
+    * 一帧的精灵绘制命令
+    * 各个Entity只往里面追加命令，不直接碰QPainter
+    * end时按层做稳定的计数排序，同层保持追加顺序；submit可以重复提交
+    * 和上一帧的命令对比可以得到这一帧真正变化的屏幕区域
+    * 所有数组在帧之间复用，稳定后不再分配内存
+    * 命令本身不引用任何Entity，整个列表复制一份就是这一帧的快照，可以交给渲染线程
+*/
+class DrawList {
+public:
+    void begin();
+    int size() const { return m_commands.size(); }
+    bool isEmpty() const { return m_commands.isEmpty(); }
+
+    void add(int spriteId, const QPointF& topLeft, DrawLayer layer, qreal extraScale = 1.0);
+    // 普通帧或预先合成好的复合精灵，按精灵的原点偏移放置
+    void addSprite(int spriteId, const QPointF& topLeft, DrawLayer layer);
+
+    // 收集完毕，按层排序
+    void end();
+    // 提交排好序的命令，clipRect不为空时跳过完全在它外面的命令
+    void submit(QPainter* painter, const SpriteAtlas& atlas, const QRectF& clipRect = QRectF()) const;
+
+    // 命令在画布上覆盖的区域
+    QRectF commandRect(const DrawCommand& command) const;
+    // 所有命令覆盖区域的并集
+    QRectF boundingRect() const;
+    // 和上一帧相比新增或消失的命令所覆盖的区域
+    void addChangedRects(const DrawList& previous, QVector<QRect>& rects) const;
+
+    void swap(DrawList& other);
+
+private:
+    QVector<DrawCommand> m_commands;
+    QVector<DrawCommand> m_sorted;
+    mutable QVector<DrawCommand> m_diffCurrent;
+    mutable QVector<DrawCommand> m_diffPrevious;
+};
+
+#endif // DRAWLIST_H
@@ -2,15 +2,20 @@
 #define ENTITY_H
 #include "view/Animation.h"
 #include "view/SpriteManager.h"
+#include "view/DrawList.h"
 
-class Entity : public QObject {
-    Q_OBJECT
+/*
+    * 渲染用的实体都是普通对象，不继承QObject
+    * 动画片段由SpriteManager共享，实体里只保存播放头，怪物由EntityPool复用
+    * 怪物尸体和爆炸一样交给ParticleSystem，不再是实体
+*/
+class Entity {
 public:
-    explicit Entity(QObject* parent = nullptr);
+    Entity();
     virtual ~Entity();
 
     virtual void update(double deltaTime);
-    virtual void paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset);
+    virtual void paint(DrawList& drawList, const QPointF& viewOffset);
 
     void setPosition(const QPointF& pos) { m_position = pos; }
     const QPointF& getPosition() const { return m_position; }
@@ -41,11 +46,9 @@ enum class PlayerState {
     Zombie
 };
 class PlayerEntity : public Entity {
-    Q_OBJECT
 public:
-    PlayerEntity(QObject* parent = nullptr);
-    ~PlayerEntity() override;
-    void paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) override;
+    PlayerEntity();
+    void paint(DrawList& drawList, const QPointF& viewOffset) override;
     void setState(PlayerState newState);
     void update(double deltaTime);
     bool isVisible() const;
@@ -53,12 +56,11 @@ public:
     void setInvincible(bool res) {m_isInvincible = res;}
     void setInvincibilityTime(int t) {m_invincibilityTimer = t;}
     PlayerState getState() { return m_currentState; }
-public slots:
     void onGameWin();
 private:
-    QMap<PlayerState, Animation*> m_animations;
+    static const AnimationClip* clipFor(PlayerState state);
     PlayerState m_currentState; 
-    Animation* m_currentAnimation;
+    Animation m_animation;
     double m_invincibilityTimer = 0;
     bool m_isInvincible = false;
     bool m_isGamewin = false;
@@ -84,51 +86,33 @@ enum class MonsterType {
     imp
 };
 class MonsterEntity : public Entity {
-    Q_OBJECT
 public:
-    explicit MonsterEntity(const MonsterType& monsterType, QObject* parent = nullptr);
-    ~MonsterEntity() override;
+    MonsterEntity() = default;
+    // 从池里取出后重新初始化，不分配内存
+    void spawn(MonsterType type);
     void update(double deltaTime) override;
-    void paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) override;
+    void paint(DrawList& drawList, const QPointF& viewOffset) override;
     void setState(MonsterState newState);
     void setVelocity(const QPointF& velocity);
     void setFrozen(bool frozen) { m_isFrozen = frozen; }
     bool isFrozen() const { return m_isFrozen; }
     void deploy(); 
     MonsterType getType() const {return monsterType;}
+    const AnimationClip* deathClip() const; // 死亡动画，交给粒子系统播放
     void onHit(); //
+    quint32 syncStamp = 0; // GameWidget同步敌人时的帧号，没被标记到的已经消失
 private:
-    void updateAnimation(); // 新增：根据状态更新动画
-    Animation* m_currentAnimation;
-    QMap<MonsterState, Animation*> m_animations;
+    static constexpr int STATE_COUNT = static_cast<int>(MonsterState::Deployed) + 1;
+    // 每个状态一个播放头，切换状态时各自保留进度
+    Animation m_animations[STATE_COUNT];
     QPointF m_velocity; 
-    MonsterType  monsterType;
-    MonsterState m_currentState;
+    MonsterType  monsterType = MonsterType::orc;
+    MonsterState m_currentState = MonsterState::Walking;
+    bool m_isDeployed = false;
     bool m_isFrozen = false; 
     double m_hitTimer = 0; // 用于处理被击中后的短暂无敌时间
 };
 
-enum class DeadMonsterState {
-    Dying, 
-    Dead   
-};
-
-class DeadMonsterEntity : public Entity {
-    Q_OBJECT
-public:
-    explicit DeadMonsterEntity(const MonsterEntity& monserentity);
-    ~DeadMonsterEntity() override;
-    void update(double deltaTime) override;
-    void paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) override;
-    void setState(DeadMonsterState newState) { m_currentState = newState; }
-    bool ShouldbeRemove() { return m_lingerTimer <= 0; }
-private:
-    Animation* m_animation;
-    MonsterType monsterType;
-    DeadMonsterState m_currentState;
-    double m_lingerTimer;
-};
-
 enum class ItemState {
     Drop, 
     Flash,
@@ -169,20 +153,23 @@ enum class ItemType {
         vendor_badge         // 治安官徽章 - 10金币
 };
 class ItemEntity : public Entity {
-    Q_OBJECT
 public:
-    explicit ItemEntity(int itemtype, QObject* parent = nullptr, QPointF position = QPointF(-25, 0));
+    explicit ItemEntity(int itemtype, QPointF position = QPointF(-25, 0));
     ~ItemEntity() { };
     void update(double deltaTime) override;
-    void paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) override;
+    void paint(DrawList& drawList, const QPointF& viewOffset) override;
     void setState(ItemState newState) { m_currentState = newState; }
     void setLingerTimer(double timer) { m_lingerTimer = timer; }
+    void setDrawLayer(DrawLayer layer) { m_drawLayer = layer; }
     ItemState getState() { return m_currentState; }
     int getType() const { return m_itemType; }  // 返回int类型
     bool isVisible();
     static QString typeToString(int type); // 改为使用int类型
+    static int typeToSpriteId(int type);   // 绘制时用，查表不拼字符串
 private:
     int m_itemType; // 改为使用int类型
+    int m_spriteId;
+    DrawLayer m_drawLayer = DrawLayer::Item;
     ItemState m_currentState;
     double m_lingerTimer;
 };
@@ -198,12 +185,10 @@ enum class VendorState {
 };
  
 class VendorEntity : public Entity {
-    Q_OBJECT
 public:
-    explicit VendorEntity(QObject* parent = nullptr);
-    ~VendorEntity() override;
+    VendorEntity();
     void update(double deltaTime, const QPointF& playerPosition);
-    void paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) override;
+    void paint(DrawList& drawList, const QPointF& viewOffset) override;
     void setState(VendorState newState) { m_currentState = newState; }
     VendorState getState() const { return m_currentState; }
     
@@ -211,14 +196,17 @@ public:
     void setAvailableItems(const QList<int>& items) { m_availableItems = items; }
     QList<int> getAvailableItems() const { return m_availableItems; }
     
-public slots:
     void onVendorAppear();
     void onVendorDisappear();
     void onGameWin();
 private:
-    QMap<VendorState, Animation*> m_animations;
+    static constexpr int STATE_COUNT = static_cast<int>(VendorState::Disappearing) + 1;
+    static const AnimationClip* clipFor(VendorState state);
+    // 每个状态一个播放头，和怪物一样切换状态时各自保留进度
+    Animation m_animations[STATE_COUNT];
     VendorState m_currentState;
     Animation* m_currentAnimation;
+    int m_tableclothSpriteId;
     double m_lingerTimer = 6.0;
     QList<int> m_availableItems = {};  // 默认空列表，会被动态更新
 };
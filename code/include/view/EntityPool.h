@@ -0,0 +1,35 @@
+#ifndef ENTITYPOOL_H
+#define ENTITYPOOL_H
+
+#include <QVector>
+#include <deque>
+
+/*
+    * 渲染实体的对象池
+    * 对象存在deque里，扩容时已有对象的地址不变，GameWidget可以直接保存指针
+    * 释放的对象进空闲列表，下次acquire时复用，由调用方负责重新初始化（spawn）
+    * 池只增不减，高峰过后保留下来的对象留给下一波怪物用
+*/
+template <typename T>
+class EntityPool {
+public:
+    T* acquire() {
+        if (!m_free.isEmpty()) {
+            return m_free.takeLast();
+        }
+        m_storage.emplace_back();
+        return &m_storage.back();
+    }
+
+    void release(T* object) {
+        if (object) m_free.append(object);
+    }
+
+    int capacity() const { return static_cast<int>(m_storage.size()); }
+
+private:
+    std::deque<T> m_storage;
+    QVector<T*> m_free;
+};
+
+#endif // ENTITYPOOL_H
@@ -0,0 +1,65 @@
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include "view/DrawList.h"
+
+// 文字和进度条不走精灵表，单独记录，用于判断是否需要重画
+// 坐标都是原始像素；文字不画在画布上，由GameWidget放大之后按窗口分辨率画
+struct HudFrame {
+    QString healthText, moneyText;
+    QPointF healthTextPos, moneyTextPos;
+    QRectF healthTextRect, moneyTextRect;
+    bool showTimeBar = false;
+    QRectF timeBarRect;
+    int timeBarFill = 0;
+    QRectF bounds;      // 界面精灵覆盖的范围，即缓存层的大小
+};
+
+// 渲染线程画一帧需要的全部数据，GUI线程填好后不再修改
+// 里面的QImage和列表都是隐式共享的，复制只是加引用计数
+struct RenderFrame {
+    QSize size;                   // 画布大小，原始像素
+    SpriteAtlas atlas;
+    DrawList world;               // 地图范围内的精灵
+    DrawList ui;                  // 地图外的界面精灵
+    QImage mapLayer;              // 静态图块层
+    QImage nextMapLayer;          // 转场时的下一张地图
+    QPointF mapOffset;
+    QPointF nextMapOffset;
+    QRectF worldClipRect;
+    bool lightningOnly = false;   // 闪电特效期间只画闪电和玩家
+    HudFrame hud;
+    int hudVersion = 0;           // 界面内容的版本，变了才重建界面缓存层
+    QRegion dirty;                // 需要重画的区域，为空表示整帧重画
+};
+
+/*
+    * 渲染线程上的画帧器
+    * 按RenderFrame把一帧按原始像素1:1画到自己持有的小QImage上，只重画脏区域，画完把图片发回GUI线程
+    * GUI线程那边的paintEvent只负责把图片整数倍放大贴到窗口上
+    * 发出去的图片和画布共享数据，下一帧开始画时画布自动分离出一份，GUI线程手里的那份不受影响
+    * 界面精灵先画到一张缓存层上，只在界面内容变化时重建，每帧只画进度条
+*/
+class FrameRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FrameRenderer(QObject *parent = nullptr);
+    // 在渲染线程里调用
+    void render(const RenderFrame& frame);
+
+signals:
+    void frameReady(const QImage& image, const QRegion& dirty);
+
+private:
+    void paintHud(QPainter* painter, const RenderFrame& frame);
+    void rebuildHudLayer(const RenderFrame& frame);
+
+    QImage m_canvas;
+    QImage m_hudLayer;
+    QPointF m_hudOrigin;
+    int m_hudVersion = -1;
+    qint64 m_hudSheetKey = 0;
+};
+
+#endif // FRAMERENDERER_H
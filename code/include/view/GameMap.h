@@ -1,48 +1,51 @@
 #ifndef GAMEMAP_H
 #define GAMEMAP_H
 
-#include <QFile>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
 #include "view/SpriteManager.h"
 #include "view/Animation.h"
-
-class ExplosionEffect {
-public:
-    ExplosionEffect(const QPointF& position);
-    ~ExplosionEffect();
-    void update(double deltaTime);
-    void paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset);
-    bool isFinished() const { return m_animation ? m_animation->isFinished() : true; }
-private:
-    QPointF m_position; 
-    Animation* m_animation; 
-};
+#include "view/DrawList.h"
+#include "common/GameMap.h"
 
 class GameMapView {
 public:
     GameMapView(QString map_title);
-    ~GameMapView() { qDeleteAll(m_animations); qDeleteAll(m_explosions); }
-    bool loadFromFile(const QString& path, const QString& mapName, const QString& layoutName);
+    ~GameMapView() { qDeleteAll(m_animations); }
+    // 从LevelCatalog取布局
+    bool loadLayout(const QString& mapName, const QString& layoutName);
+    // 换成目录里的另一个布局，不读文件也不解析
+    bool setLayout(const MapLayout* layout);
     int getTileIdAt(int row, int col) const;
     QString getTileSpriteName(int tileId) const;
-    void paint(QPainter *painter, const QPixmap &spriteSheet, const QPointF &viewOffset);
+    // 原始像素的静态图块层，需要时先重建；返回的图片可以交给渲染线程
+    const QImage& staticLayer(const SpriteAtlas& atlas);
+    void collectSprites(DrawList& drawList, const QPointF &viewOffset) const;
+    int getLayoutVersion() const { return m_layoutVersion; } // 每次加载布局加一
     void update(double deltaTime);
     int getWidth() const;
     int getHeight() const;
     QString getMapTitle() const { return map_title; }
-    void setMapTitle(const QString& title) { map_title = title;}
+    void setMapTitle(const QString& title);
     void addTile(int row, int col, int tileId);
-    void createExplosion(const QPointF& position);
 private:
-    QList<QList<int>> m_tiles;       // 存储地图布局的二维列表
-    QMap<int, QString> m_tileLegend; // 存储图块ID到精灵名字的映射
+    const MapLayout* m_layout = nullptr; // 指向LevelCatalog里的布局
     QMap<QString, Animation*> m_animations;
-    QList<ExplosionEffect*> m_explosions;
     QString map_title;
+    int m_houseSpriteId = SpriteManager::INVALID_ID;
     int m_width;
     int m_height;  
+
+    // 静态图块每个布局只画一次，缓存成原始像素的整张图；动画图块每帧单独叠加
+    struct AnimatedTile {
+        int row;
+        int col;
+        Animation* animation;
+    };
+    void rebuildTileCache(const SpriteAtlas& atlas);
+    QImage m_staticLayer;
+    QVector<AnimatedTile> m_animatedTiles;
+    qint64 m_staticLayerSheetKey = 0; // 生成缓存时精灵表的cacheKey，精灵表换了就重建
+    bool m_tileCacheDirty = true;
+    int m_layoutVersion = 0;
 };
 
 #endif // GAMEMAP_H
\ No newline at end of file
@@ -5,9 +5,15 @@
 #include "view/Animation.h"
 #include "view/SpriteManager.h"
 #include "view/Entity.h"
+#include "view/EntityPool.h"
+#include "view/ParticleSystem.h"
+#include "view/FrameRenderer.h"
+#include <QThread>
+#include <QStaticText>
 
 class GameWidget : public QWidget {
     Q_OBJECT
+    friend class RenderBenchmark; // 离线基准测试直接驱动场景和取帧
 
 public:
     GameWidget(QWidget *parent = nullptr);
@@ -17,12 +23,26 @@ public:
     // 设置可购买的供应商物品列表（通过信号槽机制）
     void setAvailableVendorItems(const QList<int>& items);
 
+    // 由Application的帧时钟按顺序调用
+    void processInput();                // 读取按键，发出移动和射击
+    void updateView(double deltaTime);  // 推进动画和特效
+    void renderFrame();                 // 收集绘制命令并交给渲染线程
+
 protected:
     void paintEvent(QPaintEvent *event) override;
-    void paintUi(QPainter *painter, const QPointF& viewOffset, const QRectF& mapRect);
+    void resizeEvent(QResizeEvent *event) override;
+    void updateCanvasSize(); // 按窗口大小选整数放大倍数和原始像素画布的大小
+    void buildFrame();      // 收集这一帧的绘制命令
+    void updateHud(const QPointF& viewOffset, const QRectF& mapRect);
+    void buildUi(const QPointF& viewOffset, const QRectF& mapRect);
+    void scheduleRepaint(); // 和上一帧对比，只重画变化的区域
+    void queueRender(const QRegion& dirty, bool fullRepaint);
+    void dispatchFrame();   // 把当前帧的快照交给渲染线程
+    RenderFrame captureFrame(const QRegion& dirty);
+    // 把原始像素的一帧按scale倍最近邻放大画出来，再按放大后的分辨率画计数文字；闪电特效期间不画文字
+    void presentFrame(QPainter* painter, const QImage& frame, const HudFrame& hud, bool lightningOnly, qreal scale);
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
-    void timerEvent();
     void syncEnemies();
     void syncItems();
     void playerLivesDown();
@@ -48,15 +68,15 @@ signals:
 public slots:
     // void onStateUpdated();
     void die(int id);
-    void gameLoop(); // 临时函数
     void playerPositionChanged(QPointF position);
     void startMapTransition(const QString& nextMapName, const QString& nextLayoutName);
-    void onMapChanged();
+    void startMapTransition(const MapLayout* nextLayout);
+    void onMapChanged(const MapLayout* layout);
     // GameViewModel的游戏时间是已游玩时间，而GameWidget的游戏时间是剩余时间
     void updateGameTime(double gameTime);
-    void updateBullets(QList<BulletData> bullets);
+    void updateBullets(BulletView bullets);
     void updateEnemies(QList<EnemyData> enemies);
-    void updateItems(QList<ItemData> items);
+    void updateItems(ItemView items, double itemTime);
     void updatePlayerStealthMode(bool isStealth);
     void updatePlayerHealth(int health);
     void updatePlayerMoney(int money);
@@ -75,25 +95,90 @@ public slots:
     void triggerLightning(const QPointF& startPosition);
     void onGameWin();
 
+private slots:
+    void onFrameReady(const QImage& image, const QRegion& dirty);
+
 private:
     QTimer* keyRespondTimer;
     QMap<int, bool> keys;
-    QTimer* m_timer;            // 临时变量
-    QElapsedTimer m_elapsedTimer; // 临时变量
     GameMapView* m_gameMap;
     GameMapView* m_nextMap = nullptr;
-    QPixmap m_spriteSheet;
+    SpriteAtlas m_atlas;  // 原始大小的精灵表，画布上1:1拷贝
+    QSize m_canvasSize;   // 原始像素画布的大小，地图居中，四周是界面
+    int m_pixelScale = 1; // 画布放大到窗口的倍数，按物理像素算，一定是整数
+    struct FrameState {
+        QPointF viewOffsetMap;
+        QPointF nextMapOffset;
+        QRectF worldClipRect;
+        bool showNextMap = false;
+        bool lightningOnly = false;
+        const GameMapView* map = nullptr;
+        int mapVersion = -1;
+        HudFrame hud;
+        int hudVersion = 0;     // 界面内容每变一次加一
+    };
+    // 决定界面内容的全部状态，有变化时才重新收集界面
+    struct HudKey {
+        QPointF viewOffset;
+        QRectF mapRect;
+        int health = -1;
+        int money = -1;
+        int possessedItemType = -1;
+        bool transitioning = false;
+        bool showTimeBar = false;
+        QList<int> upgrades;    // 已购买的升级道具
+        bool sameLayout(const HudKey& other) const {
+            return viewOffset == other.viewOffset && mapRect == other.mapRect
+                && health == other.health && money == other.money
+                && possessedItemType == other.possessedItemType
+                && transitioning == other.transitioning && showTimeBar == other.showTimeBar;
+        }
+    };
+    HudKey m_hudKey;
+    DrawList m_worldList;     // 地图范围内的精灵绘制命令
+    DrawList m_uiList;        // 地图外的界面精灵
+    DrawList m_prevWorldList; // 上一帧的命令，用于计算脏矩形
+    DrawList m_prevUiList;
+    FrameState m_frame;
+    FrameState m_prevFrame;
+    QVector<QRect> m_dirtyRects;
+    bool m_fullRepaint = true;
+    // 渲染线程，同一时间最多有一帧在画，期间新的脏区域先累积起来
+    QThread m_renderThread;
+    FrameRenderer* m_renderer = nullptr;
+    QImage m_frameImage;        // 渲染线程最近画好的一帧，原始像素
+    HudFrame m_frameHud;        // 这一帧的计数文字
+    int m_frameScale = 1;       // 这一帧对应的放大倍数
+    bool m_frameLightningOnly = false; // 这一帧是不是闪电特效画面
+    HudFrame m_dispatchedHud;   // 正在画的那一帧的文字、倍数和闪电标记，画完后换成上面三个
+    int m_dispatchedScale = 1;
+    bool m_dispatchedLightningOnly = false;
+    QStaticText m_healthText;   // 文字没变时沿用排好的版
+    QStaticText m_moneyText;
+    bool m_renderBusy = false;
+    bool m_hasPendingFrame = false;
+    bool m_pendingFull = false;
+    QRegion m_pendingDirty;
+    struct {
+        int lightning1 = SpriteManager::INVALID_ID, lightning2 = SpriteManager::INVALID_ID, bullet = SpriteManager::INVALID_ID;
+        int itemGround = SpriteManager::INVALID_ID, health = SpriteManager::INVALID_ID;
+        int money = SpriteManager::INVALID_ID, circle = SpriteManager::INVALID_ID;
+    } m_sprites;          // 每帧都要画的精灵ID，加载sprite.json后解析一次
     PlayerEntity* player;
     VendorEntity* vendor;
-    QMap<int, MonsterEntity*> m_monsters; 
-    QMap<int, DeadMonsterEntity*> m_deadmonsters;
+    // 怪物从池里取，消失时还回池里，刷怪不再分配内存
+    EntityPool<MonsterEntity> m_monsterPool;
+    QHash<int, MonsterEntity*> m_monsters;
+    QVector<MonsterEntity*> m_monsterDrawOrder;  // 按敌人数据的顺序绘制，每次同步时重建
+    ParticleSystem m_particles;                  // 爆炸、烟雾和怪物尸体
+    quint32 m_enemySyncStamp = 0;
     QMap<int, ItemEntity*> m_items;
     ItemEntity* m_purchasedItem = nullptr;
     QMap<int, ItemEntity*> ui_items; 
 
-    bool m_isTransitioning;
-    double m_transitionDuration;
-    double m_transitionTimer;
+    bool m_isTransitioning = false;
+    double m_transitionDuration = 2.0;
+    double m_transitionTimer = 0.0;
     QPointF m_transitionStartOffset;
     QPointF m_transitionEndOffset;
     bool m_isGamePaused = false;
@@ -107,16 +192,17 @@ private:
     /*
     这些变量需要随着GameViewModel内值的变化而变化
     */
-    QList<BulletData> m_bullets; // 存储子弹数据
+    BulletView m_bullets; // 子弹池的只读视图
     QList<EnemyData> m_enemyDataList;
-    QList<ItemData> m_itemDataList;
-    bool m_playerStealthMode;
+    ItemView m_itemDataList; // 道具列表的只读视图
+    double m_itemTime = 0.0; // 道具时钟，用来换算道具剩余时间
+    bool m_playerStealthMode = false;
     double m_maxTime;      
     double m_currentTime;
     int m_healthCount = 4;
     int m_moneyCount = 0;
-    int m_possessedItemType;
-    bool m_hasPossessedItem;
+    int m_possessedItemType = -1;
+    bool m_hasPossessedItem = false;
     
     // 道具使用相关
     bool m_pauseKeyPressed = false;
@@ -132,6 +218,8 @@ private:
     
     // 辅助函数：将EnemyData的enemyType转换为MonsterType
     MonsterType enemyTypeToMonsterType(int enemyType);
+    void releaseMonsters();
+    void spawnExplosion(const QPointF& position);
 };
 
 #endif
@@ -0,0 +1,52 @@
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include "view/SpriteManager.h"
+#include "view/DrawList.h"
+
+// 粒子种类，各自有独立的数量上限
+enum class ParticleKind : quint8 {
+    Effect,     // 爆炸、烟雾，播完就消失
+    Corpse,     // 怪物尸体，播完停在最后一帧，再停留一段时间
+    Count
+};
+
+/*
+    * 爆炸、烟雾和怪物尸体共用的粒子系统
+    * 按结构体数组存放，容量在构造时固定，之后生成和销毁都不分配内存
+    * 活着的粒子紧凑地排在数组前面，update一趟完成推进动画和剔除，剔除时保持原有顺序，绘制顺序不变
+    * 每种粒子有数量上限：特效满了新的直接丢弃，尸体满了替换剩余停留时间最短的那个
+    * 这样怪物成群死亡再加上炸弹，粒子数量也不会超过上限，每帧开销有界
+*/
+class ParticleSystem {
+public:
+    static constexpr int EFFECT_BUDGET = 64;
+    static constexpr int CORPSE_BUDGET = 192;
+    static constexpr int CAPACITY = EFFECT_BUDGET + CORPSE_BUDGET;
+
+    ParticleSystem();
+
+    // clip必须是不循环的共享片段，position为地图坐标，linger为播完后继续停留的秒数
+    void spawn(ParticleKind kind, const AnimationClip* clip, const QPointF& position, DrawLayer layer, double linger = 0.0);
+    void update(double deltaTime);
+    void collectSprites(DrawList& drawList, const QPointF& viewOffset) const;
+    void clear();
+    int size() const { return m_count; }
+
+private:
+    int evictCorpse() const;
+    bool isLastFrame(int index) const { return m_frameIndex[index] >= m_clip[index]->frameIds.size() - 1; }
+
+    QVector<float> m_x;
+    QVector<float> m_y;
+    QVector<float> m_frameTime;         // 当前帧已经播放的时间
+    QVector<float> m_linger;            // 播完后剩余的停留时间
+    QVector<int> m_frameIndex;
+    QVector<const AnimationClip*> m_clip;
+    QVector<DrawLayer> m_layer;
+    QVector<ParticleKind> m_kind;
+    int m_count = 0;
+    int m_kindCount[static_cast<int>(ParticleKind::Count)] = {};
+};
+
+#endif // PARTICLESYSTEM_H
@@ -0,0 +1,37 @@
+#ifndef RENDERBENCHMARK_H
+#define RENDERBENCHMARK_H
+
+class GameWidget;
+
+/*
+    * 离线渲染基准测试
+    * 用法：MaodieAdventure --bench [--frames N] [--scene 名字]... [--golden 目录]
+    * 没有显示器时自动使用offscreen平台，GameWidget不显示，按脚本摆好场景后逐帧画到QImage上
+    * 每个场景分别统计收集绘制命令、画帧和放大到窗口三部分的耗时分位数，指定--golden时保存最后一帧放大后的PNG用于对比
+*/
+class RenderBenchmark {
+public:
+    // 命令行里有--bench时返回true，需要在创建QApplication之前判断
+    static bool isRequested(int argc, char *argv[]);
+    static int run(const QStringList& arguments);
+
+private:
+    struct Scene {
+        const char* name;
+        int monsterCount;
+        int bulletCount;
+        bool explosions;
+        bool transition;
+    };
+    struct Timings {
+        QVector<qint64> buildNs;
+        QVector<qint64> renderNs;
+        QVector<qint64> presentNs;
+    };
+
+    static const Scene SCENES[];
+    static Timings runScene(const Scene& scene, int frames, QImage* lastFrame);
+    static void report(const char* sceneName, const Timings& timings);
+};
+
+#endif // RENDERBENCHMARK_H
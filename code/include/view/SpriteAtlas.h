@@ -0,0 +1,23 @@
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+/*
+    * 原始大小的精灵表
+    * 画布按原始像素绘制，精灵都是1:1拷贝，放大只在贴到窗口时做一次
+    * 精灵表存成QImage，复制一份交给渲染线程只读使用是安全的，QPixmap只能在GUI线程用
+*/
+class SpriteAtlas {
+public:
+    void setSource(const QImage& spriteSheet);
+    const QImage& source() const { return m_source; }
+    bool isNull() const { return m_source.isNull(); }
+    qint64 cacheKey() const { return m_source.cacheKey(); }
+
+    // 1:1绘制，topLeft为画布坐标
+    void draw(QPainter* painter, const QPointF& topLeft, const QRect& sourceRect) const;
+
+private:
+    QImage m_source;
+};
+
+#endif // SPRITEATLAS_H
@@ -4,34 +4,95 @@
 #include <QPoint>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <deque>
+#include "common/AssetPack.h"
 
 // 一个描述复合精灵的部件的结构体
 struct SpritePart {
-    QString frameName; // 引用的基础帧的名字
+    int frameId;       // 引用的基础帧的ID
     QPoint offset;     // 相对偏移
 };
 
+// 复合精灵部件的只读区间，指向SpriteManager里的连续数组，不做拷贝
+struct SpritePartList {
+    const SpritePart* first = nullptr;
+    int count = 0;
+    const SpritePart* begin() const { return first; }
+    const SpritePart* end() const { return first + count; }
+    bool isEmpty() const { return count == 0; }
+};
+
+// 不可变的动画片段，同样的名字、帧率和循环方式全局只有一份，所有实体共用
+struct AnimationClip {
+    QVector<int> frameIds;
+    double frameDuration = 0.0;   // 秒，为0时停在第一帧
+    bool loops = true;
+};
+
+/*
+    * 精灵管理
+    * 加载sprite.json时把所有帧名和复合精灵名统一编成连续的整数ID
+    * 名字只在加载和创建对象时使用，绘制时一律用ID直接下标访问数组
+    * 复合精灵在bakeComposites时预先合成到精灵表下方，之后和普通帧一样一次画完
+*/
 class SpriteManager {
 public:
+    static constexpr int INVALID_ID = -1;
+
     static SpriteManager& instance();
     bool loadFromFile(const QString& path);
-    QRect getSpriteRect(const QString& name) const;
+    // 从资源包加载，复合精灵在打包时已经合成好，不需要再调用bakeComposites
+    bool loadFromPack(const AssetPack& pack);
+
+    // 名字转ID，找不到返回INVALID_ID
+    int getSpriteId(const QString& name) const;
 
-    //根据名字获取复合精灵的所有部件
-    QList<SpritePart> getCompositeParts(const QString& compositeName) const;
+    QRect getSpriteRect(int spriteId) const {
+        return spriteId >= 0 && spriteId < m_spriteRects.size() ? m_spriteRects[spriteId] : QRect();
+    }
+    QRect getSpriteRect(const QString& name) const { return getSpriteRect(getSpriteId(name)); }
+    // 精灵左上角相对绘制位置的偏移，只有部件偏移为负的复合精灵不为0
+    QPoint getSpriteOrigin(int spriteId) const {
+        return spriteId >= 0 && spriteId < m_spriteOrigins.size() ? m_spriteOrigins[spriteId] : QPoint();
+    }
 
-    //返回组成动画的（简单或复合）帧名列表
-    QList<QString> getAnimationSequence(const QString& animationName) const;
+    // 按ID顺序排列的所有精灵名字和所有动画名字，打包资源时使用
+    QStringList spriteNames() const;
+    QStringList animationNames() const;
+
+    //根据ID获取复合精灵的所有部件，普通帧返回空区间
+    SpritePartList getCompositeParts(int spriteId) const;
+
+    // 把所有复合精灵合成到精灵表下方，返回扩展后的精灵表
+    // 复合精灵的源矩形随之指向合成好的区域，需要在loadFromFile之后调用
+    QImage bakeComposites(const QImage& spriteSheet);
+
+    //返回组成动画的（简单或复合）帧ID列表，加载时已经解析好
+    QVector<int> getAnimationSequence(const QString& animationName) const;
+
+    // 共享的动画片段，没有这个动画时返回nullptr
+    // 帧列表加载时解析，同一帧率和循环方式第一次请求时登记，之后返回同一个指针
+    // 重新加载sprite.json时已登记的片段原地更新帧列表，指针一直有效
+    const AnimationClip* getAnimationClip(const QString& animationName, double frameRate, bool loops);
 
 private:
     SpriteManager() = default;
     ~SpriteManager() = default;
     SpriteManager(const SpriteManager&) = delete;
     SpriteManager& operator=(const SpriteManager&) = delete;
-    
-    QMap<QString, QRect> m_spriteRects;
-    QMap<QString, QList<SpritePart>> m_composites; // 用于存储复合精灵
-    QJsonObject m_rootObject;
+
+    int internSprite(const QString& name);
+    void refreshClips();
+
+    QHash<QString, int> m_spriteIds;        // 名字 -> ID，只在加载期使用
+    QVector<QRect> m_spriteRects;           // 按ID存放的源矩形，复合精灵合成前为空矩形
+    QVector<QPoint> m_spriteOrigins;        // 按ID存放的合成区域相对绘制位置的偏移
+    QVector<int> m_compositeFirst;          // 按ID存放的部件起始下标
+    QVector<int> m_compositeCount;          // 按ID存放的部件数量，普通帧为0
+    QVector<SpritePart> m_compositeParts;   // 所有复合精灵的部件连续存放
+    QHash<QString, QVector<int>> m_animationFrames;  // 动画名 -> 帧ID列表，加载时解析
+    std::deque<AnimationClip> m_clips;               // deque追加时不移动已有元素
+    QHash<QString, QVector<int>> m_clipVariants;     // 动画名 -> m_clips里的下标
 };
 
-#endif // SPRITEMANAGER_H
\ No newline at end of file
+#endif // SPRITEMANAGER_H
@@ -1,30 +1,49 @@
 #ifndef __BULLET_VIEW_MODEL_H__
 #define __BULLET_VIEW_MODEL_H__
 
+#include <array>
+
 class BulletViewModel : public QObject {
     Q_OBJECT
 public:
+    // 子弹池容量：徽章+轮子+霰弹枪每0.1秒最多24发，最长飞行约1.5秒
+    static constexpr int MAX_BULLETS = 512;
 
     BulletViewModel(QObject *parent = nullptr);
     ~BulletViewModel();
     void createBullet(const QPointF& position, const QPointF& direction, double speed, int damage = 1);
+    // 批量生成子弹，directions必须已经是单位向量（见ShotPatterns）
+    void createBullets(const QPointF& position, const QPointF* directions, int count, double speed, int damage = 1);
     void updateBullets(double deltaTime);
     void removeBullet(int bulletId);
     void removeBullets();
     void clearAllBullets();
-    QList<BulletData> getActiveBullets() const;
-    int getBulletCount() const { return m_bullets.size(); }
+    void recomputeLifetimes(); // 地图布局变化后重新计算飞行中子弹的寿命
+    BulletView getActiveBullets() const { return BulletView(m_pool.data(), m_activeSlots.data(), &m_activeCount); }
+    int getBulletCount() const { return m_activeCount; }
+    int getHighWaterMark() const { return m_highWaterMark; } // 子弹池同时占用的最大槽位数
     int getBulletDamage(int bulletId) const; // 获取指定子弹的伤害值
     void updateBulletDamage(int bulletId, int newDamage); // 更新子弹伤害值
 signals:
-    void bulletsChanged(QList<BulletData> bullets);
+    void bulletsChanged(BulletView bullets);
 
 private:
-    QList<BulletData> m_bullets; // 存储所有子弹数据
+    // 固定容量的子弹池：空闲槽位用栈管理，活动槽位紧凑存放，生成和回收都不分配内存
+    std::array<BulletData, MAX_BULLETS> m_pool;
+    std::array<int, MAX_BULLETS> m_freeSlots;   // 空闲槽位栈
+    std::array<int, MAX_BULLETS> m_activeSlots; // 活动子弹所在的槽位
+    std::array<int, MAX_BULLETS> m_activeIndex; // 槽位在m_activeSlots中的下标
+    int m_freeCount = 0;
+    int m_activeCount = 0;
+    int m_highWaterMark = 0;
     int m_nextBulletId = 0; 
+    static constexpr int BULLET_SIZE = 5;
     QPointF normalize(const QPointF& point);
+    const BulletData* findBullet(int bulletId) const;
+    void spawnBullet(const QPointF& position, const QPointF& velocity, int damage);
+    void releaseSlot(int slot);
 };
     
 
 
-#endif
\ No newline at end of file
+#endif
@@ -17,12 +17,12 @@ public:
     // 碰撞检测
     void checkCollisions(const PlayerViewModel& player,
                         const QList<EnemyData>& enemies,
-                        const QList<BulletData>& bullets);
+                        const BulletView& bullets);
     
     void checkPlayerEnemyCollisions(const PlayerViewModel& player,
                                    const QList<EnemyData>& enemies);
     
-    void checkBulletEnemyCollisions(const QList<BulletData>& bullets,
+    void checkBulletEnemyCollisions(const BulletView& bullets,
                                    const QList<EnemyData>& enemies,
                                    int bulletDamage = 1);
 
@@ -48,6 +48,10 @@ public:
     bool isPointInWalkableTile(const QPointF& point) const;
     // 矩形与地图碰撞检测
     bool isRectCollidingWithMap(const QPointF& position, int size) const;
+    // 按轴依次移动方块（先x后y），被地图挡住时贴着障碍物停下
+    QPointF moveRectInMap(const QPointF& position, const QPointF& movement, int size) const;
+    // 沿直线匀速运动的方块多久后撞墙或飞出地图（秒）
+    double computeRectLifetime(const QPointF& position, const QPointF& velocity, int size) const;
     
 
 signals:
@@ -61,6 +65,7 @@ private:
     double m_bulletWidth = 5.0;
 
     double calculateDistance(const QPointF& pos1, const QPointF& pos2) const;
+    double clampAxisMove(const QPointF& position, double delta, int size, bool horizontal) const;
     void logCollision(const QString& type, int id1, int id2);
 };
 
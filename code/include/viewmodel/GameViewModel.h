@@ -9,6 +9,7 @@
 #include "viewmodel/ItemViewModel.h"
 #include "viewmodel/ItemEffectManager.h"
 #include "viewmodel/VendorManager.h"
+#include "viewmodel/LevelPrefetcher.h"
 
 class GameViewModel : public QObject {
     Q_OBJECT
@@ -37,8 +38,8 @@ public:
     void playerAttack(const QPointF& direction);
     void setPlayerMoveDirection(const QPointF& direction, bool isMoving);
     void useItem() { if(m_item) m_item->usePossessedItem(); }
-    QList<ItemData> getActiveItems() const { 
-        return m_item ? m_item->getActiveItems() : QList<ItemData>(); 
+    ItemView getActiveItems() const { 
+        return m_item ? m_item->getActiveItems() : ItemView(); 
     }
     int getPossessedItemType() const {return m_item->getPossessedItemType();}
         
@@ -60,8 +61,8 @@ signals:
     void itemUsed(int itemType); 
     void gameTimeChanged(double gameTime);
     void enemiesChanged(QList<EnemyData> enemies);
-    void itemsChanged(QList<ItemData> items);
-    void mapChanged();
+    void itemsChanged(ItemView items);
+    void mapChanged(const MapLayout* layout);  // 逻辑层已经换到新布局，视图用同一份解析结果转场
     void gameWin();  // 游戏胜利信号
     void vendorAppeared();
     void vendorDisappeared();
@@ -77,6 +78,7 @@ private:
     std::unique_ptr<ItemViewModel> m_item;
     std::unique_ptr<ItemEffectManager> m_itemEffectManager;
     std::unique_ptr<VendorManager> m_vendorManager;
+    std::unique_ptr<LevelPrefetcher> m_levelPrefetcher;
     double m_gameTime = 0.0;   
     int m_currentArea = 11;  // 当前区域，从1-1开始
     bool m_vendorActivated = false;  // 供应商是否已激活
@@ -93,6 +95,8 @@ private:
     void handleItemUsed(int itemType);
     void handleItemUsedImmediately(int itemType);
     void clearAllGameElements();  // 清除所有游戏元素
+    static int followingArea(int area);
+    void prefetchNextArea();
 };
 
 #endif // GAMEVIEWMODEL_H
@@ -0,0 +1,127 @@
+#ifndef __ITEM_CATALOG_H__
+#define __ITEM_CATALOG_H__
+
+#include "viewmodel/ItemEffectManager.h"
+
+/*
+    * 道具目录
+    * 名称、描述、效果持续时间、掉落权重、供应商价格集中在一张编译期表里，按ItemType下标直接访问
+    * 掉落用Walker别名法，别名表同样在编译期按掉落权重建好，抽样是O(1)
+*/
+namespace ItemCatalog {
+
+struct ItemInfo {
+    int type;
+    const char* name;         // 转换成中文这样debug信息清楚一点
+    const char* description;
+    double effectDuration;    // 效果持续时间（秒），0表示没有持续效果
+    int dropWeight;           // 敌人死亡掉落权重，0表示不会掉落
+    int vendorPrice;          // 供应商价格，0表示不在供应商出售
+};
+
+using IE = ItemEffectManager;
+
+constexpr ItemInfo ITEMS[] = {
+    {IE::coin,              "1 Coin",     "增加1个硬币数量",                                  0.0,  10, 0},
+    {IE::five_coins,        "5 Coin",     "增加5个硬币数量",                                  0.0,  30, 0},
+    {IE::extra_life,        "额外生命",   "你的总生命值加一",                                 0.0,  10, 0},
+    {IE::coffee,            "咖啡",       "增加你的移动速率",                                 10.0, 10, 0},
+    {IE::machine_gun,       "重机枪",     "大幅增加开火速率",                                 8.0,  8,  0},
+    {IE::bomb,              "清屏核弹",   "瞬间摧毁所有屏幕上的敌人",                         0.0,  7,  0},
+    {IE::shotgun,           "霰弹枪",     "每次射击会朝开火方向射出三枚方向呈锥状分散的子弹", 10.0, 7,  0},
+    {IE::smoke_bomb,        "烟雾弹",     "将你的角色传送至屏幕上随机地点并赋予潜行",         5.0,  6,  0},
+    {IE::tombstone,         "墓碑",       "一道闪电击中你的角色，在一定时间内将你转变成僵尸", 8.0,  5,  0},
+    {IE::wheel,             "轮子",       "你可以一次对8个方向射出子弹",                      12.0, 4,  0},
+    {IE::badge,             "治安官徽章", "提高开火速率和移动速率，并使你能像使用霰弹枪那样锥状射击", 15.0, 3, 0},
+
+    // 供应商道具
+    {IE::vendor_boots_1,    "靴子",       "提高移动速度",                                     0.0,  0,  2},
+    {IE::vendor_boots_2,    "靴子",       "提高移动速度",                                     0.0,  0,  5},
+    {IE::vendor_extra_life, "额外生命",   "获得额外一条生命，当供应商下一次出现的时候，可以再次购买", 0.0, 0, 3},
+    {IE::vendor_gun_1,      "枪",         "提高射击速度",                                     0.0,  0,  3},
+    {IE::vendor_gun_2,      "枪",         "提高射击速度",                                     0.0,  0,  6},
+    {IE::vendor_gun_3,      "枪",         "提高射击速度",                                     0.0,  0,  10},
+    {IE::vendor_ammo_1,     "弹药",       "把子弹的杀伤值提高到2/3/4。子弹具有穿透性",        0.0,  0,  5},
+    {IE::vendor_ammo_2,     "弹药",       "把子弹的杀伤值提高到2/3/4。子弹具有穿透性",        0.0,  0,  8},
+    {IE::vendor_ammo_3,     "弹药",       "把子弹的杀伤值提高到2/3/4。子弹具有穿透性",        0.0,  0,  12},
+    {IE::vendor_badge,      "治安官徽章", "获得一枚治安官徽章，当供应商下一次出现的时候，可以再次购买", 0.0, 0, 3},
+};
+
+constexpr int ITEM_TYPE_COUNT = sizeof(ITEMS) / sizeof(ITEMS[0]);
+
+constexpr bool isIndexedByType() {
+    for (int i = 0; i < ITEM_TYPE_COUNT; ++i) {
+        if (ITEMS[i].type != i) return false;
+    }
+    return true;
+}
+static_assert(isIndexedByType(), "ITEMS必须按ItemType顺序排列");
+static_assert(ITEM_TYPE_COUNT == IE::vendor_badge + 1, "ItemType新增类型后需要补充目录");
+
+// 未知类型返回nullptr
+constexpr const ItemInfo* find(int itemType) {
+    return itemType >= 0 && itemType < ITEM_TYPE_COUNT ? &ITEMS[itemType] : nullptr;
+}
+
+// Walker别名表（整数版）：每列以 prob/totalWeight 的概率取本列道具，否则取别名列
+struct DropTable {
+    int count = 0;
+    int totalWeight = 0;
+    int items[ITEM_TYPE_COUNT] = {};
+    int prob[ITEM_TYPE_COUNT] = {};
+    int alias[ITEM_TYPE_COUNT] = {};
+};
+
+constexpr DropTable buildDropTable() {
+    DropTable table;
+    int scaled[ITEM_TYPE_COUNT] = {};
+    for (int i = 0; i < ITEM_TYPE_COUNT; ++i) {
+        if (ITEMS[i].dropWeight > 0) {
+            table.items[table.count] = ITEMS[i].type;
+            table.totalWeight += ITEMS[i].dropWeight;
+            ++table.count;
+        }
+    }
+    // 权重乘以列数后和totalWeight比较，全程整数，没有舍入误差
+    int small[ITEM_TYPE_COUNT] = {};
+    int large[ITEM_TYPE_COUNT] = {};
+    int smallCount = 0;
+    int largeCount = 0;
+    for (int i = 0; i < table.count; ++i) {
+        scaled[i] = ITEMS[table.items[i]].dropWeight * table.count;
+        if (scaled[i] < table.totalWeight) small[smallCount++] = i;
+        else large[largeCount++] = i;
+    }
+    while (smallCount > 0 && largeCount > 0) {
+        int s = small[--smallCount];
+        int l = large[--largeCount];
+        table.prob[s] = scaled[s];
+        table.alias[s] = l;
+        scaled[l] -= table.totalWeight - scaled[s];
+        if (scaled[l] < table.totalWeight) small[smallCount++] = l;
+        else large[largeCount++] = l;
+    }
+    while (largeCount > 0) {
+        int l = large[--largeCount];
+        table.prob[l] = table.totalWeight;
+        table.alias[l] = l;
+    }
+    while (smallCount > 0) {
+        int s = small[--smallCount];
+        table.prob[s] = table.totalWeight;
+        table.alias[s] = s;
+    }
+    return table;
+}
+
+constexpr DropTable DROP_TABLE = buildDropTable();
+
+// 按别名表随机选择一种道具
+inline int sampleDrop(const DropTable& table, QRandomGenerator* random) {
+    int column = random->bounded(table.count);
+    int roll = random->bounded(table.totalWeight);
+    return table.items[roll < table.prob[column] ? column : table.alias[column]];
+}
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define ITEMEFFECTMANAGER_H
 
 #include <QVector>
+#include <array>
+#include "common/TimerWheel.h"
 
 // 前向声明
 class PlayerViewModel;
@@ -21,6 +23,7 @@ public:
         ZOMBIE_MODE,         // 僵尸模式
         STEALTH_MODE         // 潜行模式
     };
+    static constexpr int EFFECT_TYPE_COUNT = STEALTH_MODE + 1;
     
     // 效果结构体
     struct ItemEffect {
@@ -124,7 +127,9 @@ private:
     void checkAndRemoveExpiredEffects(double currentTime, PlayerViewModel* player);
     
 private:
-    QMap<EffectType, ItemEffect> m_activeEffects;  // 当前激活的效果
+    std::array<ItemEffect, EFFECT_TYPE_COUNT> m_activeEffects;  // 按效果类型索引，isActive表示是否生效
+    TimerWheel m_effectTimers;   // 效果到期调度，key为效果类型
+    QVector<int> m_expiredEffects;
     double m_currentTime = 0.0;  // 当前游戏时间
 };
 
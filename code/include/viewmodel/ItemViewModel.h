@@ -2,6 +2,8 @@
 #define __ITEM_VIEW_MODEL_H__
 
 #include <QPoint>
+#include "common/TimerWheel.h"
+#include "viewmodel/ItemCatalog.h"
 
 class ItemViewModel : public QObject {
 
@@ -13,14 +15,14 @@ public:
     
     // 道具数据管理
     void createItem(const QPointF& position, int type);
-    void createItem(const QPointF& position, QMap<int, double> itemPossibilities);
+    void createItem(const QPointF& position, const ItemCatalog::DropTable& dropTable);
     void updateItems(double deltaTime, const QPointF& playerPosition);
     void clearAllItems();
     
     // 道具栏管理
     bool hasPossessedItem() const { return m_possessingItem; }
     int getPossessedItemType() const { return m_possessedItem.type; }
-    QList<ItemData> getActiveItems() const;
+    ItemView getActiveItems() const { return ItemView(&m_items); }
     
     // 道具使用
     void usePossessedItem();
@@ -35,7 +37,7 @@ signals:
     void itemUsedImmediately(int itemType); // 道具立即使用信号
     void itemUsed(int itemType); // 道具使用信号
     void itemSpawned(int itemType, const QPointF& position); // 道具生成信号
-    void itemsChanged(const QList<ItemData>& items); // 道具列表变化信号
+    void itemsChanged(ItemView items, double itemTime); // 道具列表变化信号，itemTime为当前道具时钟
     void possessedItemChanged(int itemType, bool isPossessed); // 道具栏变化信号
 
 private:
@@ -45,6 +47,10 @@ private:
     bool m_possessingItem = false;
     QMap<QPair<int, int>, int> m_itemPositions;
     double m_spawnProbability = 0.3; // 默认30%概率生成道具
+    double m_itemTime = 0.0;          // 道具时钟，道具的消失时刻以它为准
+    TimerWheel m_expiryTimers;        // 地上道具的消失调度，key为道具id
+    QVector<int> m_expiredItems;
+    static constexpr double ITEM_LIFETIME = 15.0; // 道具在地上停留的时间
     
     void useItemImmediately(const ItemData& item); // 立即使用道具
     int selectRandomItemType() const; // 选择随机道具类型
@@ -0,0 +1,41 @@
+#ifndef LEVELPREFETCHER_H
+#define LEVELPREFETCHER_H
+
+#include <QObject>
+#include <QThread>
+#include "common/GameMap.h"
+
+// 预先准备好的下一个布局：视图直接用目录里的布局，逻辑用已经算好通行图的GameMap
+struct PreparedLevel {
+    const MapLayout* layout = nullptr;
+    GameMap simMap;
+};
+
+/*
+    * 下一个布局的后台预取
+    * 布局本身在LevelCatalog里已经解析好，这里在工作线程里提前算好下一个布局的通行图
+    * 切换布局的那一帧直接取结果，GUI线程不再做任何准备工作
+    * 同一时间只保留最近一次请求的结果，旧的请求完成后直接丢弃
+*/
+class LevelPrefetcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit LevelPrefetcher(QObject *parent = nullptr);
+    ~LevelPrefetcher();
+
+    void request(const QString& mapName, const QString& layoutName);
+    // 取走预取好的结果；还没准备好或者不是这个布局时当场同步加载
+    PreparedLevel take(const QString& mapName, const QString& layoutName);
+
+private:
+    static PreparedLevel prepare(const QString& mapName, const QString& layoutName);
+
+    QThread m_thread;
+    QObject* m_worker;
+    int m_generation = 0;   // 每次请求加一，用来丢弃过期的结果
+    bool m_hasReady = false;
+    PreparedLevel m_ready;
+};
+
+#endif // LEVELPREFETCHER_H
@@ -52,7 +52,7 @@ public:
     double getMoveSpeed() const { return m_stats.moveSpeed; }
     QPointF getShootingDirection() const { return m_stats.shootingDirection; }
     BulletViewModel* getBulletViewModel() const { return m_bulletViewModel.get(); }
-    QList<BulletData> getActiveBullets() const {
+    BulletView getActiveBullets() const {
         return m_bulletViewModel->getActiveBullets();
     }
     
@@ -0,0 +1,77 @@
+#ifndef __SHOT_PATTERNS_H__
+#define __SHOT_PATTERNS_H__
+
+/*
+    * 射击方向表
+    * 所有方向都是编译期写好的单位向量，射击时直接批量写入子弹池，不再逐发atan2/cos/sin和归一化
+    * 霰弹枪为中心方向左右各偏30度，斜向的中心方向偏出后落在15度/75度上
+*/
+namespace ShotPatterns {
+
+constexpr double COS45 = 0.70710678118654752;
+constexpr double COS30 = 0.86602540378443865;
+constexpr double COS15 = 0.96592582628906829;
+constexpr double SIN15 = 0.25881904510252076;
+
+// 射击输入只会是方向键组合，按 (dy+1)*3 + (dx+1) 编号，4 表示没有方向；其它方向返回-1
+constexpr int compassIndex(double dx, double dy) {
+    return (dx == 0 || dx == 1 || dx == -1) && (dy == 0 || dy == 1 || dy == -1)
+           ? static_cast<int>((dy + 1) * 3 + (dx + 1)) : -1;
+}
+
+// 单发：方向键组合归一化后的方向
+constexpr QPointF SINGLE[9] = {
+    QPointF(-COS45, -COS45), // 左上
+    QPointF(0.0, -1.0),      // 上
+    QPointF(COS45, -COS45),  // 右上
+    QPointF(-1.0, 0.0),      // 左
+    QPointF(0.0, 0.0),       // 无方向
+    QPointF(1.0, 0.0),       // 右
+    QPointF(-COS45, COS45),  // 左下
+    QPointF(0.0, 1.0),       // 下
+    QPointF(COS45, COS45),   // 右下
+};
+
+// 霰弹枪（徽章模式同样使用）：左30度、中心、右30度
+constexpr int SHOTGUN_COUNT = 3;
+constexpr QPointF SHOTGUN[9][SHOTGUN_COUNT] = {
+    {QPointF(-COS15, -SIN15), QPointF(-COS45, -COS45), QPointF(-SIN15, -COS15)}, // 左上
+    {QPointF(-0.5, -COS30), QPointF(0.0, -1.0), QPointF(0.5, -COS30)},           // 上
+    {QPointF(SIN15, -COS15), QPointF(COS45, -COS45), QPointF(COS15, -SIN15)},    // 右上
+    {QPointF(-COS30, 0.5), QPointF(-1.0, 0.0), QPointF(-COS30, -0.5)},           // 左
+    {QPointF(0.0, 0.0), QPointF(0.0, 0.0), QPointF(0.0, 0.0)},                   // 无方向
+    {QPointF(COS30, -0.5), QPointF(1.0, 0.0), QPointF(COS30, 0.5)},              // 右
+    {QPointF(-SIN15, COS15), QPointF(-COS45, COS45), QPointF(-COS15, SIN15)},    // 左下
+    {QPointF(0.5, COS30), QPointF(0.0, 1.0), QPointF(-0.5, COS30)},              // 下
+    {QPointF(COS15, SIN15), QPointF(COS45, COS45), QPointF(SIN15, COS15)},       // 右下
+};
+
+// 轮子：上、右上、右、右下、下、左下、左、左上
+constexpr int WHEEL_COUNT = 8;
+constexpr QPointF WHEEL[WHEEL_COUNT] = {
+    QPointF(0.0, -1.0),      // 上
+    QPointF(COS45, -COS45),  // 右上
+    QPointF(1.0, 0.0),       // 右
+    QPointF(COS45, COS45),   // 右下
+    QPointF(0.0, 1.0),       // 下
+    QPointF(-COS45, COS45),  // 左下
+    QPointF(-1.0, 0.0),      // 左
+    QPointF(-COS45, -COS45), // 左上
+};
+
+// 轮子+霰弹枪：轮子的8个方向各打一组霰弹
+constexpr int WHEEL_SHOTGUN_COUNT = WHEEL_COUNT * SHOTGUN_COUNT;
+constexpr QPointF WHEEL_SHOTGUN[WHEEL_SHOTGUN_COUNT] = {
+    QPointF(-0.5, -COS30), QPointF(0.0, -1.0), QPointF(0.5, -COS30),           // 上
+    QPointF(SIN15, -COS15), QPointF(COS45, -COS45), QPointF(COS15, -SIN15),    // 右上
+    QPointF(COS30, -0.5), QPointF(1.0, 0.0), QPointF(COS30, 0.5),              // 右
+    QPointF(COS15, SIN15), QPointF(COS45, COS45), QPointF(SIN15, COS15),       // 右下
+    QPointF(0.5, COS30), QPointF(0.0, 1.0), QPointF(-0.5, COS30),              // 下
+    QPointF(-SIN15, COS15), QPointF(-COS45, COS45), QPointF(-COS15, SIN15),    // 左下
+    QPointF(-COS30, 0.5), QPointF(-1.0, 0.0), QPointF(-COS30, -0.5),           // 左
+    QPointF(-COS15, -SIN15), QPointF(-COS45, -COS45), QPointF(-SIN15, -COS15), // 左上
+};
+
+}
+
+#endif
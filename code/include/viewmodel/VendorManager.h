@@ -59,6 +59,7 @@ private:
     QList<VendorItemConfig> m_vendorItems;
     
     void initializeVendorItems();
+    void addVendorItem(int itemType, int slotIndex, int itemIndex, bool isInfinitePurchase = false);
     void unlockNextItem(int slotIndex);
     int getSlotIndex(int itemType) const;
     bool isItemAvailable(int itemType) const;
@@ -1,8 +1,17 @@
 #include "view/MainWindow.h"
 #include "app/Application.h"
+#include "view/RenderBenchmark.h"
 
 int main(int argc, char *argv[])
 {
+    // 离线渲染基准测试，不启动游戏
+    if (RenderBenchmark::isRequested(argc, argv)) {
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QApplication app(argc, argv);
+        return RenderBenchmark::run(app.arguments());
+    }
     Application a(argc, argv);
     
     return a.run();
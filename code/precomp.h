@@ -64,6 +64,7 @@ struct BulletData {
     QPointF velocity;
     bool isActive; // 是否处于活动状态
     int damage;    // 子弹伤害值，用于穿透性功能
+    double lifetime; // 剩余飞行时间，生成时按地图算出撞墙或出界的时刻
 };
 
 struct EnemyData {
@@ -102,7 +103,12 @@ struct ItemData {
     QPoint position;
     bool isPossessed;
     bool isActive;
-    double remainTime;
+    double expireTime; // 消失时刻，以ItemViewModel的道具时钟计
 };
 
+// 活动实体的只读视图，碰撞检测和渲染直接读viewmodel里的存储
+#include "common/ActiveView.h"
+typedef ActiveView<BulletData> BulletView;
+typedef ActiveView<ItemData> ItemView;
+
 #endif
\ No newline at end of file
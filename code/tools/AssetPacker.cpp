@@ -0,0 +1,233 @@
+#include "common/AssetPack.h"
+#include "view/SpriteManager.h"
+#include <QSaveFile>
+
+/*
+    * 资源打包工具，构建时由CMake调用
+    * 用法: AssetPacker <assert目录> <输出文件>
+    * 复合精灵用游戏里同一份SpriteManager合成，打包后的精灵ID和运行时从JSON加载时完全一致
+    * 像素、图块和音效都按运行时直接使用的格式写出，游戏启动时只需要映射文件
+*/
+
+using namespace AssetPackFormat;
+
+namespace {
+
+// 相同的字符串只存一份
+class StringPool {
+public:
+    StringRef add(const QString& text) {
+        auto it = m_refs.constFind(text);
+        if (it != m_refs.constEnd()) return it.value();
+        QByteArray utf8 = text.toUtf8();
+        StringRef ref = {static_cast<quint32>(m_data.size()), static_cast<quint32>(utf8.size())};
+        m_data.append(utf8);
+        m_refs.insert(text, ref);
+        return ref;
+    }
+    const QByteArray& data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+    QHash<QString, StringRef> m_refs;
+};
+
+template <typename T>
+void appendRecord(QByteArray& section, const T& record) {
+    section.append(reinterpret_cast<const char*>(&record), sizeof(T));
+}
+
+void alignTo(QByteArray& data, int alignment) {
+    while (data.size() % alignment != 0) data.append('\0');
+}
+
+bool packSprites(const QString& assetDir, StringPool& strings, QVector<QByteArray>& sections) {
+    SpriteManager& sprites = SpriteManager::instance();
+    if (!sprites.loadFromFile(assetDir + "/picture/sprite.json")) {
+        qWarning() << "无法加载sprite.json";
+        return false;
+    }
+    QImage sheet(assetDir + "/picture/sprite.png");
+    if (sheet.isNull()) {
+        qWarning() << "无法加载sprite.png";
+        return false;
+    }
+    QImage baked = sprites.bakeComposites(sheet).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const QStringList names = sprites.spriteNames();
+    for (int id = 0; id < names.size(); ++id) {
+        SpriteRecord record = {};
+        record.name = strings.add(names[id]);
+        QRect rect = sprites.getSpriteRect(id);
+        QPoint origin = sprites.getSpriteOrigin(id);
+        record.x = rect.x();
+        record.y = rect.y();
+        record.width = rect.width();
+        record.height = rect.height();
+        record.originX = origin.x();
+        record.originY = origin.y();
+        appendRecord(sections[Sprites], record);
+    }
+
+    for (const QString& name : sprites.animationNames()) {
+        const QVector<int> frameIds = sprites.getAnimationSequence(name);
+        AnimationRecord record = {};
+        record.name = strings.add(name);
+        record.firstFrame = static_cast<qint32>(sections[AnimationFrames].size() / sizeof(qint32));
+        record.frameCount = frameIds.size();
+        for (int frameId : frameIds) appendRecord(sections[AnimationFrames], static_cast<qint32>(frameId));
+        appendRecord(sections[Animations], record);
+    }
+
+    AtlasHeader atlas = {};
+    atlas.width = baked.width();
+    atlas.height = baked.height();
+    atlas.bytesPerLine = static_cast<qint32>(baked.bytesPerLine());
+    atlas.format = QImage::Format_ARGB32_Premultiplied;
+    appendRecord(sections[Atlas], atlas);
+    sections[Atlas].append(reinterpret_cast<const char*>(baked.constBits()), baked.sizeInBytes());
+    qDebug() << "精灵:" << names.size() << "动画:" << sprites.animationNames().size() << "精灵表:" << baked.size();
+    return true;
+}
+
+bool packLayouts(const QString& assetDir, StringPool& strings, QVector<QByteArray>& sections) {
+    QFile file(assetDir + "/picture/gamemap.json");
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开gamemap.json";
+        return false;
+    }
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (doc.isNull()) {
+        qWarning() << "解析gamemap.json失败:" << error.errorString();
+        return false;
+    }
+
+    // 和LevelCatalog::loadFromFile的规则一致：宽度以第一行为准，短的行补0，长的行截断
+    int layoutCount = 0;
+    QJsonObject root = doc.object();
+    for (auto mapIt = root.begin(); mapIt != root.end(); ++mapIt) {
+        QJsonObject mapObject = mapIt.value().toObject();
+        if (!mapObject.contains("tile_definitions")) continue;
+        const qint32 firstLegend = static_cast<qint32>(sections[LegendEntries].size() / sizeof(LegendRecord));
+        QJsonObject legendObject = mapObject["tile_definitions"].toObject();
+        for (auto it = legendObject.begin(); it != legendObject.end(); ++it) {
+            LegendRecord legend = {};
+            legend.tileId = it.key().toInt();
+            legend.spriteName = strings.add(it.value().toString());
+            appendRecord(sections[LegendEntries], legend);
+        }
+        const qint32 legendCount = static_cast<qint32>(sections[LegendEntries].size() / sizeof(LegendRecord)) - firstLegend;
+
+        for (auto layoutIt = mapObject.begin(); layoutIt != mapObject.end(); ++layoutIt) {
+            if (layoutIt.key() == "tile_definitions") continue;
+            QJsonArray layoutArray = layoutIt.value().toArray();
+            if (layoutArray.isEmpty()) continue;
+            LayoutRecord record = {};
+            record.mapName = strings.add(mapIt.key());
+            record.layoutName = strings.add(layoutIt.key());
+            record.width = layoutArray[0].toArray().count();
+            record.height = layoutArray.count();
+            record.firstTile = static_cast<qint32>(sections[Tiles].size() / sizeof(qint32));
+            record.firstLegend = firstLegend;
+            record.legendCount = legendCount;
+            for (int row = 0; row < record.height; ++row) {
+                QJsonArray rowArray = layoutArray[row].toArray();
+                for (int col = 0; col < record.width; ++col) {
+                    qint32 tileId = col < rowArray.count() ? rowArray[col].toInt() : 0;
+                    appendRecord(sections[Tiles], tileId);
+                }
+            }
+            appendRecord(sections[Layouts], record);
+            layoutCount++;
+        }
+    }
+    qDebug() << "布局:" << layoutCount;
+    return true;
+}
+
+bool packFiles(const QString& assetDir, StringPool& strings, QVector<QByteArray>& sections) {
+    // WAV本身就是PCM加一个很小的文件头，原样存放，播放器可以直接从内存播放
+    const QStringList directories = {"sound", "music"};
+    for (const QString& directory : directories) {
+        QDir dir(assetDir + "/" + directory);
+        for (const QString& fileName : dir.entryList(QStringList() << "*.wav", QDir::Files, QDir::Name)) {
+            QFile file(dir.filePath(fileName));
+            if (!file.open(QIODevice::ReadOnly)) {
+                qWarning() << "无法打开音效文件:" << file.fileName();
+                return false;
+            }
+            QByteArray data = file.readAll();
+            alignTo(sections[FileData], ALIGNMENT);
+            FileRecord record = {};
+            record.name = strings.add(directory + "/" + fileName);
+            record.offset = static_cast<quint64>(sections[FileData].size());
+            record.size = static_cast<quint64>(data.size());
+            sections[FileData].append(data);
+            appendRecord(sections[Files], record);
+        }
+    }
+    qDebug() << "音效文件:" << sections[Files].size() / static_cast<int>(sizeof(FileRecord));
+    return true;
+}
+
+bool writePack(const QString& path, const StringPool& strings, QVector<QByteArray>& sections) {
+    sections[Strings] = strings.data();
+
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.sectionCount = SectionCount;
+
+    // 文件头和段表之后，各段依次按16字节对齐
+    QVector<Section> table(SectionCount);
+    quint64 offset = sizeof(Header) + SectionCount * sizeof(Section);
+    for (int id = 0; id < SectionCount; ++id) {
+        offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        table[id].offset = offset;
+        table[id].size = static_cast<quint64>(sections[id].size());
+        offset += table[id].size;
+    }
+
+    QByteArray output;
+    output.reserve(static_cast<qsizetype>(offset));
+    appendRecord(output, header);
+    for (const Section& section : table) appendRecord(output, section);
+    for (int id = 0; id < SectionCount; ++id) {
+        alignTo(output, ALIGNMENT);
+        output.append(sections[id]);
+    }
+
+    // 先写临时文件再替换，构建中断也不会留下半个资源包
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(output) != output.size() || !file.commit()) {
+        qWarning() << "无法写入资源包:" << path;
+        return false;
+    }
+    qDebug() << "资源包写入完成:" << path << "大小:" << output.size() << "字节";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 合成复合精灵要用QPainter，和渲染基准测试一样用offscreen平台，不需要显示器
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    const QStringList arguments = app.arguments();
+    if (arguments.size() < 3) {
+        qWarning() << "用法: AssetPacker <assert目录> <输出文件>";
+        return 1;
+    }
+    const QString assetDir = arguments[1];
+
+    StringPool strings;
+    QVector<QByteArray> sections(SectionCount);
+    if (!packSprites(assetDir, strings, sections)) return 1;
+    if (!packLayouts(assetDir, strings, sections)) return 1;
+    if (!packFiles(assetDir, strings, sections)) return 1;
+    return writePack(arguments[2], strings, sections) ? 0 : 1;
+}
@@ -1,39 +1,40 @@
 #include "view/Animation.h"
 
-Animation::Animation(const QList<QString>& frameNames, double frameRate, bool loops)
-    : m_frameNames(frameNames), m_loops(loops), m_elapsedTime(0.0), m_currentIndex(0) {
-    if (frameRate > 0.0) {
-        m_frameDuration = 1.0 / frameRate;
-    } else {
-        m_frameDuration = 0.0;
-    }
+Animation::Animation(const AnimationClip* clip)
+    : m_clip(clip), m_elapsedTime(0.0), m_currentIndex(0) {
+}
+
+void Animation::setClip(const AnimationClip* clip) {
+    m_clip = clip;
+    reset();
 }
 
 bool Animation::isFinished() const {
-    if (!m_loops && m_currentIndex >= m_frameNames.count() - 1) {
+    if (!m_clip) return true;
+    if (!m_clip->loops && m_currentIndex >= m_clip->frameIds.count() - 1) {
         return true;
     }
     return false;
 }
 
 void Animation::update(double deltaTime) {
-    if (m_frameDuration == 0.0 || m_frameNames.isEmpty()) return;
+    if (!m_clip || m_clip->frameDuration == 0.0 || m_clip->frameIds.isEmpty()) return;
     m_elapsedTime += deltaTime;
-    if (m_elapsedTime >= m_frameDuration) {
-        m_elapsedTime -= m_frameDuration;
+    if (m_elapsedTime >= m_clip->frameDuration) {
+        m_elapsedTime -= m_clip->frameDuration;
         m_currentIndex++;
-        if (m_currentIndex >= m_frameNames.count()) {
-            if (m_loops) m_currentIndex = 0;
-            else m_currentIndex = m_frameNames.count() - 1;
+        if (m_currentIndex >= m_clip->frameIds.count()) {
+            if (m_clip->loops) m_currentIndex = 0;
+            else m_currentIndex = m_clip->frameIds.count() - 1;
         }
     }
 }
 
-const QString& Animation::getCurrentFrameName() const {
-    return m_frameNames.at(m_currentIndex);
+int Animation::getCurrentFrame() const {
+    return !m_clip || m_clip->frameIds.isEmpty() ? SpriteManager::INVALID_ID : m_clip->frameIds.at(m_currentIndex);
 }
 
 void Animation::reset() {
     m_currentIndex = 0;
     m_elapsedTime = 0.0;
-}
\ No newline at end of file
+}
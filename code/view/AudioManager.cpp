@@ -1,13 +1,44 @@
 #include "view/AudioManager.h"
+#include "common/AssetPack.h"
 #include <QUrl>
+#include <QBuffer>
+#include <QFileInfo>
 #include <memory>
 
-// 构造函数 - 初始化音频管理器
+namespace {
+// 资源包里的文件名是相对assert目录的路径，比如"sound/cowboy_dead.wav"
+QString packFileName(const QString& path)
+{
+    QFileInfo info(path);
+    return info.dir().dirName() + "/" + info.fileName();
+}
+}
+
+// 构造函数 - 只初始化状态，不创建任何播放器，启动时不等待音频后端
 AudioManager::AudioManager(QObject *parent)
     : QObject(parent)
-    , m_musicPlayer(std::make_shared<QMediaPlayer>())
-    , m_audioOutput(new QAudioOutput(this))
 {
+}
+
+// 获取AudioManager单例实例
+AudioManager& AudioManager::instance()
+{
+    static AudioManager instance;
+    return instance;
+}
+
+// 初始化音频系统 - 只创建背景音乐播放器，音效在第一次播放时再打开
+bool AudioManager::initialize()
+{
+    if (m_ready) {
+        return true;
+    }
+    qDebug() << "AudioManager::initialize() - Start";
+
+    m_musicPlayer = std::make_shared<QMediaPlayer>();
+    m_audioOutput = new QAudioOutput(this);
+    m_audioOutput->setVolume(m_musicVolume / 100.0f);
+
     // 设置背景音乐播放器的音频输出
     m_musicPlayer->setAudioOutput(m_audioOutput);
     
@@ -22,113 +53,96 @@ AudioManager::AudioManager(QObject *parent)
             this, [this](QMediaPlayer::Error error, const QString& errorString) {
                 onMediaPlayerError(static_cast<int>(error), errorString);
             });
-}
+    m_ready = true;
 
-// 获取AudioManager单例实例
-AudioManager& AudioManager::instance()
-{
-    static AudioManager instance;
-    return instance;
-}
+    // 初始化完成前请求过的背景音乐现在开始播放
+    if (m_musicPending) {
+        m_musicPending = false;
+        playMusic(m_currentMusic);
+    }
 
-// 初始化音频系统 - 加载所有音效文件和背景音乐文件
-bool AudioManager::initialize()
-{
-    qDebug() << "AudioManager::initialize() - Start";
-    
-    // 加载音效
-    loadSoundEffects();
-    
-    // 加载音乐
-    loadMusic();
-    
     qDebug() << "AudioManager::initialize() - Success";
     return true;
 }
 
-// 加载所有音效文件 - 为每个音效类型创建独立的播放器和音频输出
-void AudioManager::loadSoundEffects()
+// 打开一种音效 - 为这个音效类型创建独立的播放器和音频输出，只在第一次播放时调用
+std::shared_ptr<AudioManager::SoundPlayer> AudioManager::openSound(SoundType type)
 {
-    qDebug() << "Loading sound effects...";
-    
-    // 清理旧的音效播放器
-    m_soundPlayers.clear();
-    
-    // 为每个音效类型创建独立的播放器
-    for (int i = SHOOT; i <= BUTTON_CLICK; ++i) {
-        SoundType type = static_cast<SoundType>(i);
-        QString path = getSoundPath(type);
-        if (path.isEmpty()) {
-            qWarning() << "No path for sound type" << type;
-            continue;
-        }
+    QString path = getSoundPath(type);
+    if (path.isEmpty()) {
+        qWarning() << "No path for sound type" << type;
+        return nullptr;
+    }
 
-        // 检查文件是否存在
+    // 检查文件是否存在，资源包里有的音效不需要磁盘上的文件；取到的内容直接交给播放器
+    QByteArray packData = AssetPack::instance().file(packFileName(path));
+    qint64 fileSize = packData.size();
+    if (fileSize == 0) {
         QFile file(path);
         if (!file.exists()) {
             qWarning() << "Sound file does not exist:" << path;
-            continue;
+            return nullptr;
         }
+        fileSize = file.size();
+    }
 
-        // 检查文件大小
-        qint64 fileSize = file.size();
-        qDebug() << "Sound file size for type" << type << ":" << fileSize << "bytes";
+    // 检查文件大小
+    qDebug() << "Sound file size for type" << type << ":" << fileSize << "bytes";
 
-        // 创建新的播放器和音频输出
-        auto soundPlayer = std::make_shared<SoundPlayer>();
-        soundPlayer->player = std::make_shared<QMediaPlayer>();
-        soundPlayer->output = std::make_shared<QAudioOutput>();
-        
-        // 设置音频输出
-        soundPlayer->player->setAudioOutput(soundPlayer->output.get());
-        soundPlayer->output->setVolume(m_soundVolume / 100.0f);
-        
-        // 设置音频源
-        QUrl url = QUrl::fromLocalFile(path);
-        soundPlayer->player->setSource(url);
-        
-        // 检查设置后的状态
-        qDebug() << "Created sound player for type:" << type 
-                 << "from path:" << path
-                 << "source:" << soundPlayer->player->source()
-                 << "error:" << soundPlayer->player->error();
-        
-        // 如果出现错误，尝试重新设置源
-        if (soundPlayer->player->error() != QMediaPlayer::NoError) {
-            qWarning() << "Error setting source for sound type" << type 
-                       << "error:" << soundPlayer->player->errorString();
-            
-            // 尝试使用相对路径
-            QUrl relativeUrl = QUrl::fromLocalFile(path);
-            soundPlayer->player->setSource(relativeUrl);
-            
-            if (soundPlayer->player->error() != QMediaPlayer::NoError) {
-                qWarning() << "Failed to set source even with relative path for type" << type;
-            }
-        }
-        
-        m_soundPlayers[type] = std::move(soundPlayer);
-    }
+    // 创建新的播放器和音频输出
+    auto soundPlayer = std::make_shared<SoundPlayer>();
+    soundPlayer->player = std::make_shared<QMediaPlayer>();
+    soundPlayer->output = std::make_shared<QAudioOutput>();
+    
+    // 设置音频输出，单独设置过音量的音效用自己的音量
+    soundPlayer->player->setAudioOutput(soundPlayer->output.get());
+    soundPlayer->output->setVolume(m_soundTypeVolumes.value(type, m_soundVolume) / 100.0f);
+    
+    // 设置音频源
+    setPlayerSource(soundPlayer->player.get(), path, packData);
     
-    qDebug() << "Created" << m_soundPlayers.size() << "sound players";
+    // 检查设置后的状态
+    qDebug() << "Created sound player for type:" << type 
+             << "from path:" << path
+             << "error:" << soundPlayer->player->error();
+    
+    if (soundPlayer->player->error() != QMediaPlayer::NoError) {
+        qWarning() << "Error setting source for sound type" << type 
+                   << "error:" << soundPlayer->player->errorString();
+    }
+    return soundPlayer;
 }
 
-// 加载背景音乐文件
-void AudioManager::loadMusic()
+// 设置播放器的音频源 - 资源包里有这个文件时直接播放映射的内存，不再读磁盘
+void AudioManager::setPlayerSource(QMediaPlayer* player, const QString& path, const QByteArray& packData)
 {
-    qDebug() << "Loading music...";
-    
-    m_musicPlayer->setSource(QUrl::fromLocalFile(getMusicPath(m_currentMusic)));
+    // 上一次用的缓冲区是这里创建的，换源之后释放
+    QObject* previous = const_cast<QIODevice*>(player->sourceDevice());
+    if (packData.isEmpty()) {
+        player->setSource(QUrl::fromLocalFile(path));
+    } else {
+        QBuffer* buffer = new QBuffer(player);
+        buffer->setData(packData);
+        buffer->open(QIODevice::ReadOnly);
+        player->setSourceDevice(buffer, QUrl(QFileInfo(path).fileName()));
+    }
+    if (previous && previous->parent() == player) {
+        previous->deleteLater();
+    }
 }
 
 // 播放指定类型音效
 void AudioManager::playSound(SoundType type)
 {
-    if (!m_soundEnabled || m_muted) {
+    // 音频还没初始化好时直接丢弃，不在GUI线程上等后端
+    if (!m_soundEnabled || m_muted || !m_ready) {
         return;
     }
     auto it = m_soundPlayers.find(type);
-    if (it != m_soundPlayers.end() && it.value()) {
+    if (it == m_soundPlayers.end()) {
+        it = m_soundPlayers.insert(type, openSound(type));
+    }
+    if (it.value()) {
         auto& soundPlayer = it.value();
         
         // 检查音频输出状态
@@ -149,8 +163,6 @@ void AudioManager::playSound(SoundType type)
         if (soundPlayer->player->error() != QMediaPlayer::NoError) {
             qWarning() << "[playSound] Playback error:" << soundPlayer->player->errorString();
         }
-    } else {
-        qWarning() << "[playSound] Sound player not found for type:" << type;
     }
 }
 
@@ -167,6 +179,7 @@ void AudioManager::stopSound(SoundType type)
 void AudioManager::setSoundVolume(int volume)
 {
     m_soundVolume = qBound(0, volume, 100);
+    m_soundTypeVolumes.clear();
     
     // 更新所有音效播放器的音量
     for (auto& soundPlayer : m_soundPlayers) {
@@ -188,26 +201,21 @@ int AudioManager::getSoundVolume() const
 void AudioManager::setSoundTypeVolume(SoundType type, int volume)
 {
     int soundVolume = qBound(0, volume, 100);
+    m_soundTypeVolumes[type] = soundVolume;
     
-    // 找到指定音效的播放器并设置音量
+    // 播放器已经打开时直接设置，否则打开时再用
     auto it = m_soundPlayers.find(type);
     if (it != m_soundPlayers.end() && it.value() && it.value()->output) {
         it.value()->output->setVolume(soundVolume / 100.0f);
-        qDebug() << "Sound type" << type << "volume set to:" << soundVolume;
-    } else {
-        qWarning() << "Sound player not found for type:" << type;
     }
+    qDebug() << "Sound type" << type << "volume set to:" << soundVolume;
 }
 
 // 获取特定音效的音量
 int AudioManager::getSoundTypeVolume(SoundType type) const
 {
-    // 找到指定音效的播放器并获取音量
-    auto it = m_soundPlayers.find(type);
-    if (it != m_soundPlayers.end() && it.value() && it.value()->output) {
-        return static_cast<int>(it.value()->output->volume() * 100);
-    }
-    return m_soundVolume; // 如果找不到，返回全局音效音量
+    // 单独设置过的音效返回自己的音量
+    return m_soundTypeVolumes.value(type, m_soundVolume); // 如果没有设置过，返回全局音效音量
 }
 
 // 播放指定类型背景音乐
@@ -222,6 +230,12 @@ void AudioManager::playMusic(MusicType type)
         qWarning() << "[playMusic] Music path not found for type:" << type;
         return;
     }
+    if (!m_ready) {
+        // 初始化完成后再播放
+        m_currentMusic = type;
+        m_musicPending = true;
+        return;
+    }
     if (m_musicPlayer->playbackState() == QMediaPlayer::PlayingState && m_currentMusic == type) {
         qDebug() << "[playMusic] Music is already playing:" << musicPath;
         return;
@@ -231,26 +245,34 @@ void AudioManager::playMusic(MusicType type)
         return;
     }
     m_currentMusic = type;
-    m_musicPlayer->setSource(QUrl::fromLocalFile(musicPath));
+    setPlayerSource(m_musicPlayer.get(), musicPath, AssetPack::instance().file(packFileName(musicPath)));
     m_musicPlayer->play();
     qDebug() << "Playing music:" << musicPath;
 }
 
 void AudioManager::stopMusic()
 {
+    m_musicPending = false;
+    if (!m_musicPlayer) {
+        return;
+    }
     m_musicPlayer->stop();
     qDebug() << "Music stopped";
 }
 
 void AudioManager::pauseMusic()
 {
+    m_musicPending = false;
+    if (!m_musicPlayer) {
+        return;
+    }
     m_musicPlayer->pause();
     qDebug() << "Music paused";
 }
 
 void AudioManager::resumeMusic()
 {
-    if (m_musicEnabled && !m_muted) {
+    if (m_musicEnabled && !m_muted && m_musicPlayer) {
         m_musicPlayer->play();
         qDebug() << "Music resumed";
     }
@@ -260,7 +282,9 @@ void AudioManager::resumeMusic()
 void AudioManager::setMusicVolume(int volume)
 {
     m_musicVolume = qBound(0, volume, 100);
-    m_audioOutput->setVolume(m_musicVolume / 100.0f);
+    if (m_audioOutput) {
+        m_audioOutput->setVolume(m_musicVolume / 100.0f);
+    }
     
     emit musicVolumeChanged(m_musicVolume);
     qDebug() << "Music volume set to:" << m_musicVolume;
@@ -276,13 +300,16 @@ void AudioManager::setMuted(bool muted)
 {
     m_muted = muted;
     
-    if (muted) {
-        if (m_musicPlayer->playbackState() == QMediaPlayer::PlayingState) {
-            m_musicPlayer->pause();
-        }
-    } else {
-        if (m_musicEnabled && m_musicPlayer->playbackState() == QMediaPlayer::PausedState) {
-            m_musicPlayer->play();
+    // 还没初始化时只记下状态，初始化后由playMusic决定是否播放
+    if (m_musicPlayer) {
+        if (muted) {
+            if (m_musicPlayer->playbackState() == QMediaPlayer::PlayingState) {
+                m_musicPlayer->pause();
+            }
+        } else {
+            if (m_musicEnabled && m_musicPlayer->playbackState() == QMediaPlayer::PausedState) {
+                m_musicPlayer->play();
+            }
         }
     }
     
@@ -0,0 +1,99 @@
+#include "view/DrawList.h"
+#include "view/SpriteManager.h"
+
+#include <algorithm>
+
+namespace {
+// 对比用的全序，和绘制顺序无关
+bool commandLess(const DrawCommand& a, const DrawCommand& b) {
+    if (a.spriteId != b.spriteId) return a.spriteId < b.spriteId;
+    if (a.x != b.x) return a.x < b.x;
+    if (a.y != b.y) return a.y < b.y;
+    if (a.scale != b.scale) return a.scale < b.scale;
+    return a.layer < b.layer;
+}
+}
+
+void DrawList::begin() {
+    m_commands.clear();
+    m_sorted.clear();
+}
+
+void DrawList::add(int spriteId, const QPointF& topLeft, DrawLayer layer, qreal extraScale) {
+    if (spriteId == SpriteManager::INVALID_ID) return;
+    QRect sourceRect = SpriteManager::instance().getSpriteRect(spriteId);
+    if (sourceRect.isNull()) return;
+    m_commands.append({spriteId, topLeft.x(), topLeft.y(), extraScale, layer, sourceRect});
+}
+
+void DrawList::addSprite(int spriteId, const QPointF& topLeft, DrawLayer layer) {
+    // 复合精灵加载时已经合成进精灵表，这里和普通帧一样只有一条命令
+    QPoint origin = SpriteManager::instance().getSpriteOrigin(spriteId);
+    add(spriteId, topLeft + QPointF(origin), layer);
+}
+
+void DrawList::end() {
+    // 按层计数排序
+    constexpr int layerCount = static_cast<int>(DrawLayer::Count);
+    int layerStart[layerCount + 1] = {};
+    for (const DrawCommand& command : m_commands) {
+        layerStart[static_cast<int>(command.layer) + 1]++;
+    }
+    for (int i = 0; i < layerCount; ++i) {
+        layerStart[i + 1] += layerStart[i];
+    }
+    m_sorted.resize(m_commands.size());
+    for (const DrawCommand& command : m_commands) {
+        m_sorted[layerStart[static_cast<int>(command.layer)]++] = command;
+    }
+}
+
+void DrawList::submit(QPainter* painter, const SpriteAtlas& atlas, const QRectF& clipRect) const {
+    // 缩放为1时就是1:1拷贝
+    // 光栅引擎上drawPixmapFragments本来也是逐个绘制，直接用drawImage，渲染线程里也能用
+    const QImage& sheet = atlas.source();
+    for (const DrawCommand& command : m_sorted) {
+        QRectF targetRect = commandRect(command);
+        if (!clipRect.isNull() && !clipRect.intersects(targetRect)) continue;
+        painter->drawImage(targetRect, sheet, QRectF(command.source));
+    }
+}
+
+QRectF DrawList::commandRect(const DrawCommand& command) const {
+    return QRectF(command.x, command.y, command.source.width() * command.scale, command.source.height() * command.scale);
+}
+
+QRectF DrawList::boundingRect() const {
+    QRectF bounds;
+    for (const DrawCommand& command : m_commands) {
+        bounds = bounds.united(commandRect(command));
+    }
+    return bounds;
+}
+
+void DrawList::addChangedRects(const DrawList& previous, QVector<QRect>& rects) const {
+    // 两边各自排序后归并，只在一边出现的命令就是变化的部分
+    m_diffCurrent.resize(m_commands.size());
+    std::copy(m_commands.cbegin(), m_commands.cend(), m_diffCurrent.begin());
+    m_diffPrevious.resize(previous.m_commands.size());
+    std::copy(previous.m_commands.cbegin(), previous.m_commands.cend(), m_diffPrevious.begin());
+    std::sort(m_diffCurrent.begin(), m_diffCurrent.end(), commandLess);
+    std::sort(m_diffPrevious.begin(), m_diffPrevious.end(), commandLess);
+    int i = 0;
+    int j = 0;
+    while (i < m_diffCurrent.size() || j < m_diffPrevious.size()) {
+        if (j >= m_diffPrevious.size() || (i < m_diffCurrent.size() && commandLess(m_diffCurrent[i], m_diffPrevious[j]))) {
+            rects.append(commandRect(m_diffCurrent[i++]).toAlignedRect());
+        } else if (i >= m_diffCurrent.size() || commandLess(m_diffPrevious[j], m_diffCurrent[i])) {
+            rects.append(previous.commandRect(m_diffPrevious[j++]).toAlignedRect());
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+}
+
+void DrawList::swap(DrawList& other) {
+    m_commands.swap(other.m_commands);
+    m_sorted.swap(other.m_sorted);
+}
@@ -1,50 +1,56 @@
 #include "view/Entity.h"
 #include "Entity.h"
 
-Entity::Entity(QObject* parent) : QObject(parent), m_position(0, 0) {};
+Entity::Entity() : m_position(0, 0) {};
 
 Entity::~Entity() {}
 
 void Entity::update(double deltaTime) {}
-void Entity::paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) {}
+void Entity::paint(DrawList& drawList, const QPointF& viewOffset) {}
+
+const AnimationClip* PlayerEntity::clipFor(PlayerState state) {
+    // 每个状态对应的共享片段，第一次用时解析，Disappearing没有动画
+    static const QVector<const AnimationClip*> clips = [] {
+        SpriteManager& sprites = SpriteManager::instance();
+        QVector<const AnimationClip*> table(static_cast<int>(PlayerState::Zombie) + 1, nullptr);
+        auto set = [&](PlayerState s, const char* name, double frameRate, bool loops) {
+            table[static_cast<int>(s)] = sprites.getAnimationClip(name, frameRate, loops);
+        };
+        set(PlayerState::Idle,             "player_idle", 8.0, true);
+        set(PlayerState::WalkDown,         "player_walk_down", 8.0, true);
+        set(PlayerState::WalkUp,           "player_walk_up", 8.0, true);
+        set(PlayerState::WalkLeft,         "player_walk_left", 8.0, true);
+        set(PlayerState::WalkRight,        "player_walk_right", 8.0, true);
+        set(PlayerState::ShootDown,        "player_shoot_down", 8.0, true);
+        set(PlayerState::ShootUp,          "player_shoot_up", 8.0, true);
+        set(PlayerState::ShootLeft,        "player_shoot_left", 8.0, true);
+        set(PlayerState::ShootRight,       "player_shoot_right", 8.0, true);
+        set(PlayerState::ShootDownWalk,    "player_walk_down", 8.0, true);
+        set(PlayerState::ShootUpWalk,      "player_walk_up", 8.0, true);
+        set(PlayerState::ShootLeftWalk,    "player_walk_left", 8.0, true);
+        set(PlayerState::ShootRightWalk,   "player_walk_right", 8.0, true);
+        set(PlayerState::Lifting,          "player_lifting", 8.0, true);
+        set(PlayerState::Lightning,        "player_lightning", 4.0, true);
+        set(PlayerState::LiftingHeart,     "player_lifting_heart", 8.0, false);
+        set(PlayerState::Kiss,             "kiss", 8.0, true);
+        set(PlayerState::WalkLiftingHeart, "player_walk_lifting_heart", 8.0, true);
+        set(PlayerState::Dying,            "player_dying", 8.0, false);
+        set(PlayerState::Zombie,           "player_zombie", 8.0, true);
+        return table;
+    }();
+    return clips[static_cast<int>(state)];
+}
 
-PlayerEntity::PlayerEntity(QObject *parent) : Entity(parent) {
+PlayerEntity::PlayerEntity() {
     m_currentState = PlayerState::Idle;
-    m_animations[PlayerState::Idle]      = new Animation(SpriteManager::instance().getAnimationSequence("player_idle"), 8.0, true);
-    m_animations[PlayerState::WalkDown]  = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_down"), 8.0, true);
-    m_animations[PlayerState::WalkUp]    = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_up"), 8.0, true);
-    m_animations[PlayerState::WalkLeft]  = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_left"), 8.0, true);
-    m_animations[PlayerState::WalkRight] = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_right"), 8.0, true);
-    m_animations[PlayerState::ShootDown]  = new Animation(SpriteManager::instance().getAnimationSequence("player_shoot_down"), 8.0, true);
-    m_animations[PlayerState::ShootUp]    = new Animation(SpriteManager::instance().getAnimationSequence("player_shoot_up"), 8.0, true);
-    m_animations[PlayerState::ShootLeft]  = new Animation(SpriteManager::instance().getAnimationSequence("player_shoot_left"), 8.0, true);
-    m_animations[PlayerState::ShootRight] = new Animation(SpriteManager::instance().getAnimationSequence("player_shoot_right"), 8.0, true);
-    m_animations[PlayerState::ShootDownWalk]  = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_down"), 8.0, true);
-    m_animations[PlayerState::ShootUpWalk]    = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_up"), 8.0, true);
-    m_animations[PlayerState::ShootLeftWalk]  = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_left"), 8.0, true);
-    m_animations[PlayerState::ShootRightWalk] = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_right"), 8.0, true);
-    m_animations[PlayerState::Lifting] = new Animation(SpriteManager::instance().getAnimationSequence("player_lifting"), 8.0, true);
-    m_animations[PlayerState::Lightning] = new Animation(SpriteManager::instance().getAnimationSequence("player_lightning"), 4.0, true);
-    m_animations[PlayerState::LiftingHeart] = new Animation(SpriteManager::instance().getAnimationSequence("player_lifting_heart"), 8.0, false);
-    m_animations[PlayerState::Kiss] = new Animation(SpriteManager::instance().getAnimationSequence("kiss"), 8.0, true);
-    m_animations[PlayerState::WalkLiftingHeart] = new Animation(SpriteManager::instance().getAnimationSequence("player_walk_lifting_heart"), 8.0, true);
-    m_animations[PlayerState::Dying] = new Animation(SpriteManager::instance().getAnimationSequence("player_dying"), 8.0, false);
-    m_animations[PlayerState::Zombie] = new Animation(SpriteManager::instance().getAnimationSequence("player_zombie"), 8.0, true);
-    m_currentAnimation = m_animations.value(m_currentState, nullptr);
+    m_animation.setClip(clipFor(m_currentState));
     m_position = QPointF(16*8, 16*8);
 }
 
-PlayerEntity::~PlayerEntity() {
-    qDeleteAll(m_animations);
-}
-
 void PlayerEntity::setState(PlayerState newState) {
     if (m_currentState == newState) return; 
     m_currentState = newState;
-    m_currentAnimation = m_animations.value(m_currentState, nullptr);
-    if (m_currentAnimation) {
-        m_currentAnimation->reset(); 
-    }
+    m_animation.setClip(clipFor(m_currentState));
 }
 
 bool PlayerEntity::isVisible() const {
@@ -75,9 +81,7 @@ void PlayerEntity::update(double deltaTime) {
         }
         
     }
-    if (m_currentAnimation) {
-        m_currentAnimation->update(deltaTime);
-    }
+    m_animation.update(deltaTime);
 }
 
 void PlayerEntity::onGameWin() {
@@ -87,72 +91,60 @@ void PlayerEntity::onGameWin() {
     m_isGamewin = true;
 }
 
-void PlayerEntity::paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) {
-    if (!m_currentAnimation || m_currentState == PlayerState::Disappearing) return;
+void PlayerEntity::paint(DrawList& drawList, const QPointF& viewOffset) {
+    if (!m_animation.clip() || m_currentState == PlayerState::Disappearing) return;
     if (!isVisible()) return;
-    const QString& currentFrameName = m_currentAnimation->getCurrentFrameName();
-    QList<SpritePart> parts = SpriteManager::instance().getCompositeParts(currentFrameName);
-    double scale = 3.0; 
-    QPointF destinationAnchor(m_position.x()*scale, m_position.y()*scale);
-
-    if (!parts.isEmpty()) {
-        for (const SpritePart& part : parts) {
-            QRect sourceRect = SpriteManager::instance().getSpriteRect(part.frameName);
-            QPointF finalPos = destinationAnchor + (part.offset * scale);
-            QRectF destinationRect(finalPos, sourceRect.size() * scale);
-            destinationRect.translate(viewOffset);
-            painter->drawPixmap(destinationRect, spriteSheet, sourceRect);
-        }
-    } else {
-        QRect sourceRect = SpriteManager::instance().getSpriteRect(currentFrameName);
-        if (!sourceRect.isNull()) {
-            QRectF destinationRect(destinationAnchor, sourceRect.size() * scale);
-            destinationRect.translate(viewOffset);
-            painter->drawPixmap(destinationRect, spriteSheet, sourceRect);
-        }
-    }
+    drawList.addSprite(m_animation.getCurrentFrame(), m_position + viewOffset, DrawLayer::Player);
 }
 
-MonsterEntity::MonsterEntity(const MonsterType &monsterType, QObject *parent) : Entity(parent), monsterType(monsterType) {
+namespace {
+struct MonsterClips {
+    const AnimationClip* walk = nullptr;
+    const AnimationClip* hit = nullptr;
+    const AnimationClip* die = nullptr;
+};
+
+const MonsterClips& monsterClips(MonsterType type) {
+    // 按怪物类型下标，第一次用时解析
+    static const QVector<MonsterClips> table = [] {
+        SpriteManager& sprites = SpriteManager::instance();
+        QVector<MonsterClips> clips(static_cast<int>(MonsterType::imp) + 1);
+        auto set = [&](MonsterType t, const char* name, const char* die) {
+            MonsterClips& entry = clips[static_cast<int>(t)];
+            entry.walk = sprites.getAnimationClip(QString("%1_walk").arg(name), 8.0, true);
+            entry.hit = sprites.getAnimationClip(QString("%1_hit").arg(name), 8.0, false);
+            entry.die = sprites.getAnimationClip(die, 8.0, false);
+        };
+        set(MonsterType::orc,       "orc",       "orc_die");
+        set(MonsterType::spikeball, "spikeball", "orc_die");
+        set(MonsterType::ogre,      "ogre",      "orc_die");
+        set(MonsterType::mushroom,  "mushroom",  "orc_die");
+        set(MonsterType::pixie,     "pixie",     "pixie_die");
+        set(MonsterType::mummy,     "mummy",     "explode");
+        set(MonsterType::imp,       "imp",       "pixie_die");
+        return clips;
+    }();
+    return table[static_cast<int>(type)];
+}
+}
+
+void MonsterEntity::spawn(MonsterType type) {
+    monsterType = type;
     m_currentState = MonsterState::Walking;
     m_velocity = QPointF(0, 0);
-    switch (monsterType) {
-    case MonsterType::orc:
-        m_animations[MonsterState::Walking] = new Animation(SpriteManager::instance().getAnimationSequence("orc_walk"), 8.0, true);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("orc_hit"), 8.0, false);
-        break;
-    case MonsterType::spikeball:
-        m_animations[MonsterState::Walking] = new Animation(SpriteManager::instance().getAnimationSequence("spikeball_walk"), 8.0, true);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("spikeball_hit"), 8.0, false);
-        break;
-    case MonsterType::ogre:
-        m_animations[MonsterState::Walking] = new Animation(SpriteManager::instance().getAnimationSequence("ogre_walk"), 8.0, true);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("ogre_hit"), 8.0, false);
-        break;
-    case MonsterType::mushroom:
-        m_animations[MonsterState::Walking] = new Animation(SpriteManager::instance().getAnimationSequence("mushroom_walk"), 8.0, true);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("mushroom_hit"), 8.0, false);
-        break;
-    case MonsterType::pixie:
-        m_animations[MonsterState::Walking] = new Animation(SpriteManager::instance().getAnimationSequence("pixie_walk"), 8.0, true);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("pixie_hit"), 8.0, false);
-        break;
-    case MonsterType::mummy:
-        m_animations[MonsterState::Walking] = new Animation(SpriteManager::instance().getAnimationSequence("mummy_walk"), 8.0, true);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("mummy_hit"), 8.0, false);
-        break;
-    case MonsterType::imp:
-        m_animations[MonsterState::Walking] = new Animation(SpriteManager::instance().getAnimationSequence("imp_walk"), 8.0, true);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("imp_hit"), 8.0, false);
-        break;
-    default:
-        break;
-    }
-    m_currentAnimation = m_animations.value(m_currentState, nullptr);
+    m_position = QPointF(0, 0);
+    m_isDeployed = false;
+    m_isFrozen = false;
+    m_hitTimer = 0;
+    syncStamp = 0;
+    const MonsterClips& clips = monsterClips(type);
+    for (Animation& animation : m_animations) animation.setClip(nullptr);
+    m_animations[static_cast<int>(MonsterState::Walking)].setClip(clips.walk);
+    m_animations[static_cast<int>(MonsterState::Hit)].setClip(clips.hit);
 }
 
-MonsterEntity::~MonsterEntity() {
-    qDeleteAll(m_animations);
+const AnimationClip* MonsterEntity::deathClip() const {
+    return monsterClips(monsterType).die;
 }
 
 void MonsterEntity::setVelocity(const QPointF& velocity) {
@@ -161,35 +153,33 @@ void MonsterEntity::setVelocity(const QPointF& velocity) {
 
 void MonsterEntity::deploy() {
     if (monsterType == MonsterType::spikeball && m_currentState != MonsterState::Deployed && m_currentState != MonsterState::Hit) {
-        delete m_animations[MonsterState::Hit];
-        m_animations[MonsterState::Deployed] = new Animation(SpriteManager::instance().getAnimationSequence("spikeball_deploy"), 8.0, false);
-        m_animations[MonsterState::Hit] = new Animation(SpriteManager::instance().getAnimationSequence("spikeball_deploy_hit"), 8.0, false);
+        static const AnimationClip* deployClip = SpriteManager::instance().getAnimationClip("spikeball_deploy", 8.0, false);
+        static const AnimationClip* deployHitClip = SpriteManager::instance().getAnimationClip("spikeball_deploy_hit", 8.0, false);
+        m_animations[static_cast<int>(MonsterState::Deployed)].setClip(deployClip);
+        m_animations[static_cast<int>(MonsterState::Hit)].setClip(deployHitClip);
+        m_isDeployed = true;
         setState(MonsterState::Deployed);
     }
 }
+
 void MonsterEntity::onHit() {
     setState(MonsterState::Hit);
     m_hitTimer = 0.10;
 }
 
 void MonsterEntity::setState(MonsterState newState) {
-    if (m_currentState != newState) {
-            m_currentState = newState;
-            m_currentAnimation = m_animations.value(m_currentState, nullptr);
-    }
+    m_currentState = newState;
 }
 
 void MonsterEntity::update(double deltaTime) {
     // if (shouldBeRemoved()) return;
-    if (m_currentAnimation) {
-        m_currentAnimation->update(deltaTime);
-    }
+    m_animations[static_cast<int>(m_currentState)].update(deltaTime);
     switch (m_currentState) {
         case MonsterState::Hit:
             m_hitTimer -= deltaTime;
             if (m_hitTimer <= 0) {
                 m_hitTimer = 0;
-                if (m_animations[MonsterState::Deployed] == nullptr) {
+                if (!m_isDeployed) {
                     setState(MonsterState::Walking);
                 } else {
                     setState(MonsterState::Deployed);
@@ -205,101 +195,14 @@ void MonsterEntity::update(double deltaTime) {
     }
 }
 
-void MonsterEntity::paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) {
-    if (!m_currentAnimation) return;
-    const QString& currentFrameName = m_currentAnimation->getCurrentFrameName();
-    QList<SpritePart> parts = SpriteManager::instance().getCompositeParts(currentFrameName);
-    double scale = 3.0; 
-    QPointF destinationAnchor(m_position.x()*scale, m_position.y()*scale);
-
-    if (!parts.isEmpty()) {
-        for (const auto& part : parts) {
-            QRect sourceRect = SpriteManager::instance().getSpriteRect(part.frameName);
-            QPointF finalPos = destinationAnchor + (part.offset * scale);
-            QRectF destRect(finalPos, sourceRect.size() * scale);
-            destRect.translate(viewOffset);
-            painter->drawPixmap(destRect, spriteSheet, sourceRect);
-        }
-    } else {
-        QRect sourceRect = SpriteManager::instance().getSpriteRect(currentFrameName);
-        if (!sourceRect.isNull()) {
-            QRectF destinationRect(destinationAnchor, sourceRect.size() * scale);
-            destinationRect.translate(viewOffset);
-            painter->drawPixmap(destinationRect, spriteSheet, sourceRect);
-        }
-    }
-}
-
-DeadMonsterEntity::DeadMonsterEntity(const MonsterEntity &monserentity) 
-    : m_lingerTimer(20), m_currentState(DeadMonsterState::Dying), monsterType(monserentity.getType()){
-    m_position = monserentity.getPosition();
-    switch (monsterType) {
-    case MonsterType::orc:
-    case MonsterType::spikeball:
-    case MonsterType::ogre:
-    case MonsterType::mushroom:
-        m_animation = new Animation(SpriteManager::instance().getAnimationSequence("orc_die"), 8.0, false);
-        break;
-    case MonsterType::pixie:
-    case MonsterType::imp:
-        m_animation = new Animation(SpriteManager::instance().getAnimationSequence("pixie_die"), 8.0, false);
-        break;
-    case MonsterType::mummy:
-        m_animation = new Animation(SpriteManager::instance().getAnimationSequence("explode"), 8.0, false);
-        break;
-    default:
-        break;
-    }
-}
-
-DeadMonsterEntity::~DeadMonsterEntity() {
-    delete m_animation;
-}
-
-void DeadMonsterEntity::update(double deltaTime) {
-    switch (m_currentState) {
-        case DeadMonsterState::Dying:
-            if (m_animation->isFinished()) {
-                setState(DeadMonsterState::Dead);
-            }
-            break;
-        case DeadMonsterState::Dead:
-            if (m_lingerTimer >= 0) {
-                m_lingerTimer -= deltaTime;
-            }
-        default:
-            break;
-    }
-    m_animation->update(deltaTime);
-}
-
-void DeadMonsterEntity::paint(QPainter *painter, const QPixmap &spriteSheet, const QPointF &viewOffset) {
-    if (!m_animation) return;
-    const QString& currentFrameName = m_animation->getCurrentFrameName();
-    QList<SpritePart> parts = SpriteManager::instance().getCompositeParts(currentFrameName);
-    double scale = 3.0; 
-    QPointF destinationAnchor(m_position.x()*scale, m_position.y()*scale);
-
-    if (!parts.isEmpty()) {
-        for (const auto& part : parts) {
-            QRect sourceRect = SpriteManager::instance().getSpriteRect(part.frameName);
-            QPointF finalPos = destinationAnchor + (part.offset * scale);
-            QRectF destRect(finalPos, sourceRect.size() * scale);
-            destRect.translate(viewOffset);
-            painter->drawPixmap(destRect, spriteSheet, sourceRect);
-        }
-    } else {
-        QRect sourceRect = SpriteManager::instance().getSpriteRect(currentFrameName);
-        if (!sourceRect.isNull()) {
-            QRectF destinationRect(destinationAnchor, sourceRect.size() * scale);
-            destinationRect.translate(viewOffset);
-            painter->drawPixmap(destinationRect, spriteSheet, sourceRect);
-        }
-    }
+void MonsterEntity::paint(DrawList& drawList, const QPointF& viewOffset) {
+    const Animation& animation = m_animations[static_cast<int>(m_currentState)];
+    if (!animation.clip()) return;
+    drawList.addSprite(animation.getCurrentFrame(), m_position + viewOffset, DrawLayer::Monster);
 }
 
-ItemEntity::ItemEntity(int itemtype, QObject *parent, QPointF pos)
-    : Entity(parent), m_itemType(itemtype), m_currentState(ItemState::Drop), m_lingerTimer(15.0) {
+ItemEntity::ItemEntity(int itemtype, QPointF pos)
+    : m_itemType(itemtype), m_spriteId(typeToSpriteId(itemtype)), m_currentState(ItemState::Drop), m_lingerTimer(15.0) {
     setPosition(pos);
 }
 
@@ -309,19 +212,9 @@ void ItemEntity::update(double deltaTime) {
     }
 }
 
-void ItemEntity::paint(QPainter *painter, const QPixmap &spriteSheet, const QPointF &viewOffset) {
+void ItemEntity::paint(DrawList& drawList, const QPointF& viewOffset) {
     if (!isVisible()) return;     
-    QString framename = typeToString(m_itemType);
-    // qDebug() << "paint " << framename;
-    double scale = 3.0; 
-    QPointF destinationAnchor(m_position.x()*scale, m_position.y()*scale);
-    QRect sourceRect = SpriteManager::instance().getSpriteRect(framename);
-    if (!sourceRect.isNull()) {
-        QRectF destinationRect(destinationAnchor, sourceRect.size() * scale);
-        // qDebug() << "position " << destinationRect;
-        destinationRect.translate(viewOffset);
-        painter->drawPixmap(destinationRect, spriteSheet, sourceRect);
-    }
+    drawList.add(m_spriteId, m_position + viewOffset, m_drawLayer);
 }
 
 bool ItemEntity::isVisible() {
@@ -402,26 +295,47 @@ QString ItemEntity::typeToString(int type) {
     return stringtype;
 }
 
-VendorEntity::VendorEntity(QObject *parent): Entity(parent) {
-    m_currentState = VendorState::Disappearing;
-    m_animations[VendorState::LookDown] = new Animation(SpriteManager::instance().getAnimationSequence("vendor_look_down"), 8.0, true);
-    m_animations[VendorState::Come] = new Animation(SpriteManager::instance().getAnimationSequence("vendor_walk"), 8.0, true);
-    m_animations[VendorState::Leave] = new Animation(SpriteManager::instance().getAnimationSequence("vendor_walk"), 8.0, true);
-    m_animations[VendorState::LookLeft] = new Animation(SpriteManager::instance().getAnimationSequence("vendor_look_left"), 8.0, true);
-    m_animations[VendorState::LookRight] = new Animation(SpriteManager::instance().getAnimationSequence("vendor_look_right"), 8.0, true);
-    m_animations[VendorState::Singing] = new Animation(SpriteManager::instance().getAnimationSequence("vendor_singing"), 4.0, true);
-    m_currentAnimation = m_animations.value(m_currentState, nullptr);
+int ItemEntity::typeToSpriteId(int type) {
+    // sprite.json在GameWidget构造时就已加载，第一次调用时把所有类型解析一遍，之后直接查表
+    static const QVector<int> spriteIds = [] {
+        QVector<int> ids;
+        for (int t = 0; t <= static_cast<int>(ItemType::vendor_badge); ++t) {
+            ids.append(SpriteManager::instance().getSpriteId(typeToString(t)));
+        }
+        return ids;
+    }();
+    return type >= 0 && type < spriteIds.size() ? spriteIds[type] : SpriteManager::INVALID_ID;
 }
 
-VendorEntity::~VendorEntity() {
-    qDeleteAll(m_animations);
+const AnimationClip* VendorEntity::clipFor(VendorState state) {
+    static const QVector<const AnimationClip*> clips = [] {
+        SpriteManager& sprites = SpriteManager::instance();
+        QVector<const AnimationClip*> table(STATE_COUNT, nullptr);
+        table[static_cast<int>(VendorState::LookDown)] = sprites.getAnimationClip("vendor_look_down", 8.0, true);
+        table[static_cast<int>(VendorState::Come)] = sprites.getAnimationClip("vendor_walk", 8.0, true);
+        table[static_cast<int>(VendorState::Leave)] = sprites.getAnimationClip("vendor_walk", 8.0, true);
+        table[static_cast<int>(VendorState::LookLeft)] = sprites.getAnimationClip("vendor_look_left", 8.0, true);
+        table[static_cast<int>(VendorState::LookRight)] = sprites.getAnimationClip("vendor_look_right", 8.0, true);
+        table[static_cast<int>(VendorState::Singing)] = sprites.getAnimationClip("vendor_singing", 4.0, true);
+        return table;
+    }();
+    return clips[static_cast<int>(state)];
+}
+
+VendorEntity::VendorEntity() {
+    m_currentState = VendorState::Disappearing;
+    m_tableclothSpriteId = SpriteManager::instance().getSpriteId("tablecloth");
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        m_animations[i].setClip(clipFor(static_cast<VendorState>(i)));
+    }
+    m_currentAnimation = &m_animations[static_cast<int>(m_currentState)];
 }
 
 void VendorEntity::update(double deltaTime, const QPointF& playerPosition) {
     if (m_currentState == VendorState::Disappearing) {
         return;// Don't update position or animation if disappearing
     }
-    m_currentAnimation = m_animations.value(m_currentState, nullptr);
+    m_currentAnimation = &m_animations[static_cast<int>(m_currentState)];
     if (m_currentState == VendorState::Come) {
         // qDebug() << "VendorEntity::update: Walking";
         m_lingerTimer -= deltaTime;
@@ -449,51 +363,46 @@ void VendorEntity::update(double deltaTime, const QPointF& playerPosition) {
             setState(VendorState::Disappearing);
         }
     }
-    if (m_currentAnimation) {
-        // qDebug() << "VendorEntity::update: Current animation is not null";
-        m_currentAnimation->update(deltaTime);
-    }
+    m_currentAnimation->update(deltaTime);
 }
 
-void VendorEntity::paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) {
-    if (m_currentState == VendorState::Disappearing || !m_currentAnimation) {
+void VendorEntity::paint(DrawList& drawList, const QPointF& viewOffset) {
+    if (m_currentState == VendorState::Disappearing || !m_currentAnimation->clip()) {
         return;
     }
-    const double scale = 3.0;
-    const QString& currentFrameName = m_currentAnimation->getCurrentFrameName();
-    // qDebug() << "VendorEntity::paint currentFrameName: " << currentFrameName;
-    QRect vendorSourceRect = SpriteManager::instance().getSpriteRect(currentFrameName);
+    int currentFrame = m_currentAnimation->getCurrentFrame();
+    QRect vendorSourceRect = SpriteManager::instance().getSpriteRect(currentFrame);
 
     if (vendorSourceRect.isNull()) return;
-    QPointF vendorScreenAnchor = m_position * scale + viewOffset;
-    QRectF vendorDestRect(vendorScreenAnchor, vendorSourceRect.size() * scale);
-    painter->drawPixmap(vendorDestRect, spriteSheet, vendorSourceRect);
+    QPointF vendorScreenAnchor = m_position + viewOffset;
+    QRectF vendorDestRect(vendorScreenAnchor, QSizeF(vendorSourceRect.size()));
+    drawList.add(currentFrame, vendorDestRect.topLeft(), DrawLayer::Vendor);
 
     if (m_currentState != VendorState::Come && m_currentState != VendorState::Singing && m_currentState != VendorState::Leave) {
-        QRect tableclothSourceRect = SpriteManager::instance().getSpriteRect("tablecloth");
+        QRect tableclothSourceRect = SpriteManager::instance().getSpriteRect(m_tableclothSpriteId);
         if (tableclothSourceRect.isNull()) return;
-        QSizeF tableclothScaledSize(tableclothSourceRect.width() * scale, tableclothSourceRect.height() * scale);
+        QSizeF tableclothScaledSize(tableclothSourceRect.size());
         QPointF tableclothTopLeft(
             vendorDestRect.center().x() - tableclothScaledSize.width() / 2.0,
             vendorDestRect.bottom()
         );
         QRectF tableclothDestRect(tableclothTopLeft, tableclothScaledSize);
-        painter->drawPixmap(tableclothDestRect, spriteSheet, tableclothSourceRect); 
-        double itemSpacing = 10.0; 
-        double allItemsWidth = (m_availableItems.size() * 16 * scale) + ((m_availableItems.size() - 1) * itemSpacing);
+        drawList.add(m_tableclothSpriteId, tableclothDestRect.topLeft(), DrawLayer::Vendor);
+        // 间隔是原始像素，放大3倍后接近原来窗口上的10像素，取整数让道具落在整像素上
+        double itemSpacing = 3.0; 
+        double allItemsWidth = (m_availableItems.size() * 16) + ((m_availableItems.size() - 1) * itemSpacing);
         double currentItemX = tableclothDestRect.center().x() - allItemsWidth / 2.0;
         for (int itemType : m_availableItems) {
-            QString itemName = ItemEntity::typeToString(itemType);
-            QRect itemSourceRect = SpriteManager::instance().getSpriteRect(itemName);
+            int itemSpriteId = ItemEntity::typeToSpriteId(itemType);
+            QRect itemSourceRect = SpriteManager::instance().getSpriteRect(itemSpriteId);
             
             if (!itemSourceRect.isNull()) {
-                QSizeF itemScaledSize(itemSourceRect.width() * scale, itemSourceRect.height() * scale);
+                QSizeF itemScaledSize(itemSourceRect.size());
                 QPointF itemTopLeft(
                     currentItemX,
                     tableclothDestRect.center().y() - itemScaledSize.height() / 2.0
                 );
-                QRectF itemDestRect(itemTopLeft, itemScaledSize);
-                painter->drawPixmap(itemDestRect, spriteSheet, itemSourceRect);
+                drawList.add(itemSpriteId, itemTopLeft, DrawLayer::Vendor);
                 currentItemX += itemScaledSize.width() + itemSpacing;
             }
         }
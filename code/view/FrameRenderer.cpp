@@ -0,0 +1,71 @@
+#include "view/FrameRenderer.h"
+
+FrameRenderer::FrameRenderer(QObject *parent)
+    : QObject(parent) {
+}
+
+void FrameRenderer::render(const RenderFrame& frame) {
+    if (frame.size.isEmpty()) return;
+    QRegion dirty = frame.dirty;
+    if (m_canvas.size() != frame.size) {
+        // 窗口大小或者屏幕变了，画布重新分配，整帧重画
+        m_canvas = QImage(frame.size, QImage::Format_ARGB32_Premultiplied);
+        dirty = QRegion();
+    }
+    if (dirty.isEmpty()) {
+        dirty = QRegion(QRect(QPoint(0, 0), frame.size));
+    }
+
+    QPainter painter(&m_canvas);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setClipRegion(dirty);
+    QRectF dirtyBounds = dirty.boundingRect();
+    painter.fillRect(dirtyBounds, Qt::black);
+    if (frame.lightningOnly) {
+        frame.world.submit(&painter, frame.atlas, dirtyBounds);
+    } else {
+        painter.setClipRect(frame.worldClipRect, Qt::IntersectClip);
+        if (!frame.mapLayer.isNull()) painter.drawImage(frame.mapOffset, frame.mapLayer);
+        if (!frame.nextMapLayer.isNull()) painter.drawImage(frame.nextMapOffset, frame.nextMapLayer);
+        frame.world.submit(&painter, frame.atlas, dirtyBounds);
+        painter.setClipRegion(dirty);
+        paintHud(&painter, frame);
+    }
+    painter.end();
+    emit frameReady(m_canvas, dirty);
+}
+
+void FrameRenderer::rebuildHudLayer(const RenderFrame& frame) {
+    const HudFrame& hud = frame.hud;
+    m_hudVersion = frame.hudVersion;
+    m_hudSheetKey = frame.atlas.cacheKey();
+    QRect bounds = hud.bounds.toAlignedRect();
+    if (bounds.isEmpty()) {
+        m_hudLayer = QImage();
+        return;
+    }
+    m_hudOrigin = bounds.topLeft();
+    m_hudLayer = QImage(bounds.size(), QImage::Format_ARGB32_Premultiplied);
+    m_hudLayer.fill(Qt::transparent);
+    QPainter layerPainter(&m_hudLayer);
+    layerPainter.setRenderHint(QPainter::Antialiasing, false);
+    layerPainter.translate(-m_hudOrigin);
+    frame.ui.submit(&layerPainter, frame.atlas);
+}
+
+void FrameRenderer::paintHud(QPainter* painter, const RenderFrame& frame) {
+    const HudFrame& hud = frame.hud;
+    if (frame.hudVersion != m_hudVersion || frame.atlas.cacheKey() != m_hudSheetKey) {
+        rebuildHudLayer(frame);
+    }
+    if (!m_hudLayer.isNull()) painter->drawImage(m_hudOrigin, m_hudLayer);
+    if (hud.showTimeBar) {
+        QColor barBackgroundColor = Qt::darkGray;
+        QColor barFillColor = Qt::green;
+        QRectF barFillRect(hud.timeBarRect.topLeft(), QSizeF(hud.timeBarFill, hud.timeBarRect.height()));
+        painter->fillRect(hud.timeBarRect, barBackgroundColor);
+        painter->fillRect(barFillRect, barFillColor);
+        painter->setPen(Qt::black);
+        painter->drawRect(hud.timeBarRect);
+    }
+}
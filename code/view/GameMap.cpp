@@ -1,67 +1,43 @@
 #include "view/GameMap.h"
-GameMapView::GameMapView(QString map_title) : m_width(16), m_height(16), map_title(map_title) {
-    loadFromFile(":/assert/picture/gamemap.json", "map_1", "1");
+GameMapView::GameMapView(QString map_title) : m_width(0), m_height(0) {
+    setMapTitle(map_title);
 }
 
-bool GameMapView::loadFromFile(const QString& path, const QString& mapName, const QString& layoutName) {
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "无法打开地图文件:" << path;
-        return false;
-    }
-
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
-    if (doc.isNull()) {
-        qWarning() << "解析地图文件失败:" << error.errorString();
-        return false;
-    }
-
-    QJsonObject root = doc.object();
+bool GameMapView::loadLayout(const QString& mapName, const QString& layoutName) {
+    return setLayout(LevelCatalog::instance().layout(mapName, layoutName));
+}
 
-    QJsonObject mapObject = root[mapName].toObject();
-    if (mapObject.isEmpty()) {
-        qWarning() << "在JSON中找不到名为" << mapName << "的地图对象";
+bool GameMapView::setLayout(const MapLayout* layout) {
+    // 解析已经在关卡目录里做完，这里只建图块动画
+    if (!layout) {
         return false;
     }
-
-    m_tileLegend.clear();
-    QJsonObject legendObject = mapObject["tile_definitions"].toObject();
+    m_layout = layout;
     qDeleteAll(m_animations);
-    m_animations["explode"] = new Animation(SpriteManager::instance().getAnimationSequence("explode"), 8, false); 
-    for (auto it = legendObject.begin(); it != legendObject.end(); ++it) {
-            int tileId = it.key().toInt();
-            QString name = it.value().toString();
-            m_tileLegend[tileId] = name;
-            QList<QString> animFrames = SpriteManager::instance().getAnimationSequence(name);
-            if (!animFrames.isEmpty()) {
-                m_animations[name] = new Animation(animFrames, 1.2, true); 
-            }
+    m_animations.clear();
+    m_animatedTiles.clear();
+    m_tileCacheDirty = true;
+    m_layoutVersion++;
+    m_animations["explode"] = new Animation(SpriteManager::instance().getAnimationClip("explode", 8, false)); 
+    for (auto it = layout->legend.cbegin(); it != layout->legend.cend(); ++it) {
+        const QString& name = it.value();
+        const AnimationClip* tileClip = SpriteManager::instance().getAnimationClip(name, 1.2, true);
+        if (tileClip && !tileClip->frameIds.isEmpty()) {
+            m_animations[name] = new Animation(tileClip); 
         }
-
-    m_tiles.clear();
-    m_width = 0; 
-    m_height = 0;
-    QJsonArray layoutArray = mapObject[layoutName].toArray();
-    if (layoutArray.isEmpty()) {
-        qWarning() << "在地图" << mapName << "中找不到名为" << layoutName << "的布局，或者布局为空";
-        return false;
     }
-    
-    m_height = layoutArray.count();
-    for (const QJsonValue& rowVal : layoutArray) {
-        QList<int> row;
-        QJsonArray rowArray = rowVal.toArray();
-        if (m_height > 0 && m_width == 0) {
-            m_width = rowArray.count();
-        }
-        for (const QJsonValue& tileVal : rowArray) {
-            row.append(tileVal.toInt());
+
+    m_width = layout->width;
+    m_height = layout->height;
+    // 目录里已经按精灵名分好组，只需要查有动画的那几种
+    for (auto it = layout->tilesBySprite.cbegin(); it != layout->tilesBySprite.cend(); ++it) {
+        Animation* animation = m_animations.value(it.key(), nullptr);
+        if (!animation) continue;
+        for (const QPoint& tile : it.value()) {
+            m_animatedTiles.append({tile.y(), tile.x(), animation});
         }
-        m_tiles.append(row);
     }
-    
-    qDebug() << "地图" << mapName << "的布局" << layoutName << "加载成功，尺寸:" << m_width << "x" << m_height;
+    qDebug() << "地图" << layout->mapName << "的布局" << layout->layoutName << "加载成功，尺寸:" << m_width << "x" << m_height;
     return true;
 }
 
@@ -70,100 +46,70 @@ void GameMapView::update(double deltaTime) {
     for (Animation* anim : m_animations) {
         anim->update(deltaTime);
     }
-    for (auto it = m_explosions.begin(); it != m_explosions.end(); ) {
-        (*it)->update(deltaTime);
-        if ((*it)->isFinished()) {
-            delete *it;
-            it = m_explosions.erase(it);
-        } else {
-            ++it;
+}
+
+void GameMapView::rebuildTileCache(const SpriteAtlas& atlas) {
+    // 缓存层和画布一样是原始像素，贴到画布上是1:1
+    m_staticLayer = QImage(m_width * 16, m_height * 16, QImage::Format_ARGB32_Premultiplied);
+    m_staticLayer.fill(Qt::transparent);
+    QPainter layerPainter(&m_staticLayer);
+    layerPainter.setRenderHint(QPainter::Antialiasing, false);
+    for (int row = 0; row < getHeight(); ++row) {
+        for (int col = 0; col < getWidth(); ++col) {
+            QString spriteName = getTileSpriteName(getTileIdAt(row, col));
+            if (m_animations.contains(spriteName)) continue; // 动画图块每帧单独画
+            QRect sourceRect = SpriteManager::instance().getSpriteRect(spriteName);
+            if (sourceRect.isNull()) continue;
+            QPointF topLeft(col * sourceRect.width(), row * sourceRect.height());
+            atlas.draw(&layerPainter, topLeft, sourceRect);
         }
-    }  
+    }
+    layerPainter.end();
+    m_staticLayerSheetKey = atlas.cacheKey();
+    m_tileCacheDirty = false;
 }
 
-void GameMapView::paint(QPainter *painter, const QPixmap &spriteSheet, const QPointF &viewOffset) {
-    double scale = 3.0;
-    painter->setRenderHint(QPainter::Antialiasing, false);
+const QImage& GameMapView::staticLayer(const SpriteAtlas& atlas) {
+    if (getWidth() > 0 && (m_tileCacheDirty || m_staticLayerSheetKey != atlas.cacheKey())) {
+        rebuildTileCache(atlas);
+    }
+    return m_staticLayer;
+}
+
+void GameMapView::collectSprites(DrawList& drawList, const QPointF &viewOffset) const {
+    // 动画图块和房子加进绘制命令
     if (getWidth() > 0) {
-        for (int row = 0; row < getHeight(); ++row) {
-        for (int col = 0; col < getWidth(); ++col) {
-            int tileId = getTileIdAt(row, col);
-            QString spriteName = getTileSpriteName(tileId);
-            QRect sourceRect; 
-            if (m_animations.contains(spriteName)) {
-                Animation* anim = m_animations[spriteName];
-                const QString& currentFrameName = anim->getCurrentFrameName();
-                sourceRect = SpriteManager::instance().getSpriteRect(currentFrameName);
-            } else {
-                sourceRect = SpriteManager::instance().getSpriteRect(spriteName);
-            }
+        for (const AnimatedTile& tile : m_animatedTiles) {
+            int frame = tile.animation->getCurrentFrame();
+            QRect sourceRect = SpriteManager::instance().getSpriteRect(frame);
             if (sourceRect.isNull()) continue;
-                double destX = (col * sourceRect.width())* scale;
-                double destY = (row * sourceRect.height())* scale;
-                QRectF destRect(destX, destY, sourceRect.width() * scale, sourceRect.height() * scale);
-                destRect.translate(viewOffset);
-                painter->drawPixmap(destRect, spriteSheet, sourceRect);
-            }
+            QPointF topLeft(tile.col * sourceRect.width(), tile.row * sourceRect.height());
+            drawList.add(frame, topLeft + viewOffset, DrawLayer::Map);
         }
     }
-    if (map_title == "end") {
-        QString houseSpriteName = "house";
-        QRect houseSourceRect = SpriteManager::instance().getSpriteRect(houseSpriteName);
+    if (m_houseSpriteId != SpriteManager::INVALID_ID) {
+        QRect houseSourceRect = SpriteManager::instance().getSpriteRect(m_houseSpriteId);
         if (!houseSourceRect.isNull()) {
-            double houseScale = 3.0;
-            double houseX = ((m_width*16 - houseSourceRect.width())/ 2.0) * houseScale;
-            double houseY = ((m_height*16) / 2.0  - houseSourceRect.height()) * houseScale;
-            QRectF houseDestRect(houseX, houseY, houseSourceRect.width() * houseScale, houseSourceRect.height() * houseScale);
-            houseDestRect.translate(viewOffset);
-            painter->drawPixmap(houseDestRect, spriteSheet, houseSourceRect);
+            double houseX = (m_width*16 - houseSourceRect.width())/ 2.0;
+            double houseY = (m_height*16) / 2.0  - houseSourceRect.height();
+            drawList.add(m_houseSpriteId, QPointF(houseX, houseY) + viewOffset, DrawLayer::Map);
         }
     }
-    for (ExplosionEffect* explosion : m_explosions) {
-        explosion->paint(painter, spriteSheet, viewOffset);
-    }
 }
 
 int GameMapView::getTileIdAt(int row, int col) const {
-    if (row < 0 || row >= m_height || col < 0 || col >= m_width) {
-        return 0; 
-    }
-    return m_tiles[row][col];
+    return m_layout ? m_layout->tileAt(row, col) : 0;
 }
 
 QString GameMapView::getTileSpriteName(int tileId) const {
-    return m_tileLegend.value(tileId, "empty");
-}
-
-int GameMapView::getWidth() const { return m_width; }
-int GameMapView::getHeight() const { return m_height; }
-void GameMapView::createExplosion(const QPointF &position) {
-    m_explosions.append(new ExplosionEffect(position));
+    return m_layout ? m_layout->legend.value(tileId, "empty") : QString("empty");
 }
 
-ExplosionEffect::ExplosionEffect(const QPointF &position) {
-    auto frames = SpriteManager::instance().getAnimationSequence("explode");
-    m_animation = new Animation(frames, 6.0, false); 
-    m_position = position;
+void GameMapView::setMapTitle(const QString& title) {
+    map_title = title;
+    // 结尾地图中间画一座房子
+    m_houseSpriteId = (title == "end") ? SpriteManager::instance().getSpriteId("house") : SpriteManager::INVALID_ID;
 }
 
-ExplosionEffect::~ExplosionEffect() {
-    delete m_animation;
-}
-
-void ExplosionEffect::update(double deltaTime) {
-    if (m_animation) {
-        m_animation->update(deltaTime);
-    }
-}
-
-void ExplosionEffect::paint(QPainter* painter, const QPixmap& spriteSheet, const QPointF& viewOffset) {
-    if (!m_animation) return;
-    const QString& frameName = m_animation->getCurrentFrameName();
-    QRect sourceRect = SpriteManager::instance().getSpriteRect(frameName);
-    if (!sourceRect.isNull()) {
-        double scale = 3.0;
-        QRectF destRect(m_position * scale, sourceRect.size() * scale);
-        destRect.translate(viewOffset);
-        painter->drawPixmap(destRect, spriteSheet, sourceRect);
-    }
-}
\ No newline at end of file
+int GameMapView::getWidth() const { return m_width; }
+int GameMapView::getHeight() const { return m_height; }
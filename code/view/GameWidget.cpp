@@ -1,27 +1,51 @@
 #include "view/GameWidget.h"
 #include "GameWidget.h"
+#include <QFontMetricsF>
+#include <algorithm>
 
 #define UI_LEFT 27
 #define UI_UP 16
-#define SCALE 3
+// 地图加上四周界面至少要占的原始像素，窗口按它选整数放大倍数，1080x1080的窗口正好放大3倍
+#define MIN_CANVAS_SIZE 320
+// 计数文字的高度，原始像素
+#define HUD_FONT_PIXELS 7
 
 GameWidget::GameWidget(QWidget *parent) 
     : QWidget(parent){
-    bool isLoaded = SpriteManager::instance().loadFromFile(":/assert/picture/sprite.json");
-    if (!isLoaded) {
-        qDebug() << "错误：加载 :/assert/picture/sprite.json 文件失败！";
-        return;
+    m_renderer = new FrameRenderer();
+    m_renderer->moveToThread(&m_renderThread);
+    connect(&m_renderThread, &QThread::finished, m_renderer, &QObject::deleteLater);
+    connect(m_renderer, &FrameRenderer::frameReady, this, &GameWidget::onFrameReady);
+    m_renderThread.start();
+    // 有资源包时精灵表和合成好的复合精灵直接用映射的内存，没有时照旧解析JSON、解码PNG再合成
+    if (SpriteManager::instance().loadFromPack(AssetPack::instance())) {
+        qDebug() << "成功从资源包加载精灵表。";
+        m_atlas.setSource(AssetPack::instance().atlas());
     } else {
-        qDebug() << "成功加载 :/assert/picture/sprite.json 文件。";
-    }
-    m_spriteSheet.load(":/assert/picture/sprite.png");
-    if (m_spriteSheet.isNull()) {
-        qDebug() << "错误：加载 :/assert/picture/sprite.png 文件失败！";
-    }
+        bool isLoaded = SpriteManager::instance().loadFromFile(":/assert/picture/sprite.json");
+        if (!isLoaded) {
+            qDebug() << "错误：加载 :/assert/picture/sprite.json 文件失败！";
+            return;
+        } else {
+            qDebug() << "成功加载 :/assert/picture/sprite.json 文件。";
+        }
+        QImage spriteSheet(":/assert/picture/sprite.png");
+        if (spriteSheet.isNull()) {
+            qDebug() << "错误：加载 :/assert/picture/sprite.png 文件失败！";
+        }
+        m_atlas.setSource(SpriteManager::instance().bakeComposites(spriteSheet));
+    }
+    m_sprites.lightning1 = SpriteManager::instance().getSpriteId("lightning_1");
+    m_sprites.lightning2 = SpriteManager::instance().getSpriteId("lightning_2");
+    m_sprites.bullet = SpriteManager::instance().getSpriteId("player_bullet_1");
+    m_sprites.itemGround = SpriteManager::instance().getSpriteId("ui_item_ground");
+    m_sprites.health = SpriteManager::instance().getSpriteId("ui_helth");
+    m_sprites.money = SpriteManager::instance().getSpriteId("ui_money");
+    m_sprites.circle = SpriteManager::instance().getSpriteId("ui_circle");
     qDebug() << "开始创建GameMapView...";
     m_gameMap = new GameMapView("map_1");
     qDebug() << "GameMapView创建完成，地址:" << m_gameMap;
-    if (!m_gameMap->loadFromFile(":/assert/picture/gamemap.json", "map_1", "1")) { 
+    if (!m_gameMap->loadLayout("map_1", "1")) { 
         qWarning() << "GameWidget: 地图未能加载，地图将不会被绘制。";
     } else {
         qDebug() << "GameWidget: 地图加载成功，尺寸:" << m_gameMap->getWidth() << "x" << m_gameMap->getHeight();
@@ -31,14 +55,12 @@ GameWidget::GameWidget(QWidget *parent)
     setFocusPolicy(Qt::StrongFocus); 
     m_maxTime = MAX_GAMETIME; 
     m_currentTime = MAX_GAMETIME; 
-    m_timer = new QTimer(this); // 临时时钟
-    connect(m_timer, &QTimer::timeout, this, &GameWidget::gameLoop);
-    connect(this, &GameWidget::vendorAppear, vendor, &VendorEntity::onVendorAppear);
-    connect(this, &GameWidget::vendorDisappear, vendor, &VendorEntity::onVendorDisappear); 
-    connect(this, &GameWidget::gameWin, vendor, &VendorEntity::onGameWin);
-    connect(this, &GameWidget::gameWin, player, &PlayerEntity::onGameWin);
-    m_timer->start(16);
-    m_elapsedTimer.start();
+    connect(this, &GameWidget::vendorAppear, this, [this]() { vendor->onVendorAppear(); });
+    connect(this, &GameWidget::vendorDisappear, this, [this]() { vendor->onVendorDisappear(); });
+    connect(this, &GameWidget::gameWin, this, [this]() {
+        vendor->onGameWin();
+        player->onGameWin();
+    });
     
     // 初始化道具使用相关
     m_spaceKeyPressed = false;
@@ -48,19 +70,17 @@ GameWidget::GameWidget(QWidget *parent)
 }
 
 GameWidget::~GameWidget() {
+    m_renderThread.quit();
+    m_renderThread.wait();
     delete player;
-    qDeleteAll(m_monsters);
-    m_monsters.clear();
-    qDeleteAll(m_deadmonsters);
-    m_deadmonsters.clear();
+    delete vendor;
+    releaseMonsters();
     qDeleteAll(m_items);
     m_items.clear();
     delete m_gameMap;
 }
 
-void GameWidget::gameLoop() {
-    timerEvent();
-    double deltaTime = m_elapsedTimer.restart() / 1000.0;
+void GameWidget::updateView(double deltaTime) {
     if (m_isTransitioning) {
         m_transitionTimer += deltaTime;
         if (m_transitionTimer >= m_transitionDuration) {
@@ -79,20 +99,9 @@ void GameWidget::gameLoop() {
         syncEnemies(); 
         if (player) player->update(deltaTime);
         if (vendor)  vendor->update (deltaTime, player->getPosition());
-        for (auto& it: m_monsters) it->update(deltaTime);
+        for (MonsterEntity* monster : m_monsterDrawOrder) monster->update(deltaTime);
         syncItems();
         for (auto item : m_items) item->update(deltaTime);
-        for (auto it = m_deadmonsters.begin(); it != m_deadmonsters.end(); ) {
-            DeadMonsterEntity* deadMonster = it.value();
-            int monsterId = it.key();
-            deadMonster->update(deltaTime);
-            if (deadMonster->ShouldbeRemove()) {
-                delete deadMonster;
-                it = m_deadmonsters.erase(it);
-            } else {
-                ++it;
-            }
-        }    
         if (m_lightningEffectTimer > 0) {
             m_lightningEffectTimer -= deltaTime;
             if (m_lightningEffectTimer < 0) {
@@ -123,7 +132,12 @@ void GameWidget::gameLoop() {
     }
     if (m_gameMap) m_gameMap->update(deltaTime);
     if (m_nextMap) m_nextMap->update(deltaTime);
-    this->update();
+    m_particles.update(deltaTime);
+}
+
+void GameWidget::renderFrame() {
+    buildFrame();
+    scheduleRepaint();
 }
 
 void GameWidget::playerPositionChanged(QPointF position) {
@@ -133,12 +147,20 @@ void GameWidget::playerPositionChanged(QPointF position) {
 }
 
 void GameWidget::startMapTransition(const QString &nextMapName, const QString &nextLayoutName) {
+    startMapTransition(LevelCatalog::instance().layout(nextMapName, nextLayoutName));
+}
+
+void GameWidget::startMapTransition(const MapLayout* nextLayout) {
     if (m_isTransitioning) return;
+    if (!nextLayout) {
+        qWarning() << "转场失败：无法加载下一关地图";
+        return;
+    }
     m_isGamePaused = true;
     emit pauseGame();
-    m_nextMap = new GameMapView(nextMapName);
-    if (!m_nextMap->loadFromFile(":/assert/picture/gamemap.json", nextMapName, nextLayoutName)) {
-        qWarning() << "转场失败：无法加载下一关地图" << nextMapName;
+    m_nextMap = new GameMapView(nextLayout->mapName);
+    if (!m_nextMap->setLayout(nextLayout)) {
+        qWarning() << "转场失败：无法加载下一关地图" << nextLayout->mapName;
         delete m_nextMap;
         m_nextMap = nullptr;
         return;
@@ -146,16 +168,17 @@ void GameWidget::startMapTransition(const QString &nextMapName, const QString &n
     m_isTransitioning = true;
     m_transitionDuration = 2.0;
     m_transitionTimer = 0.0;
-    double worldContentWidth = (m_gameMap->getWidth() * 16) * SCALE;
-    double worldContentHeight = (m_gameMap->getHeight() * 16) * SCALE;
-    m_transitionStartOffset.setX((this->width() - worldContentWidth) / 2.0);
-    m_transitionStartOffset.setY((this->height() - worldContentHeight) / 2.0);
+    int worldContentWidth = m_gameMap->getWidth() * 16;
+    int worldContentHeight = m_gameMap->getHeight() * 16;
+    m_transitionStartOffset.setX((m_canvasSize.width() - worldContentWidth) / 2);
+    m_transitionStartOffset.setY((m_canvasSize.height() - worldContentHeight) / 2);
     m_transitionEndOffset.setX(m_transitionStartOffset.x());
     m_transitionEndOffset.setY(m_transitionStartOffset.y() - worldContentHeight);
 }
 
-void GameWidget::onMapChanged() {
-    startMapTransition("map_1", "2");
+void GameWidget::onMapChanged(const MapLayout* layout) {
+    // 和逻辑层指向关卡目录里的同一个布局，转场这一帧不读文件
+    startMapTransition(layout);
 }
 
 void GameWidget::playerLivesDown() {
@@ -169,17 +192,38 @@ void GameWidget::playerLivesDown() {
     m_pausedTime = 2.0;  
 }
 
-void GameWidget::paintEvent(QPaintEvent *event) {
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing, false);
+void GameWidget::updateCanvasSize() {
+    // 按物理像素选倍数，高分屏上也是整数倍放大；画布向上取整，放大后正好盖住整个窗口
+    qreal devicePixelRatio = devicePixelRatioF();
+    int pixelWidth = qRound(width() * devicePixelRatio);
+    int pixelHeight = qRound(height() * devicePixelRatio);
+    int pixelScale = qMax(1, qMin(pixelWidth, pixelHeight) / MIN_CANVAS_SIZE);
+    QSize canvasSize((pixelWidth + pixelScale - 1) / pixelScale, (pixelHeight + pixelScale - 1) / pixelScale);
+    if (pixelScale != m_pixelScale || canvasSize != m_canvasSize) {
+        m_pixelScale = pixelScale;
+        m_canvasSize = canvasSize;
+        m_fullRepaint = true;
+    }
+}
+
+void GameWidget::buildFrame() {
+    // 窗口大小或者所在屏幕变了时换画布，没变化时什么都不做
+    updateCanvasSize();
+    // 上一帧的命令留着做对比
+    m_prevWorldList.swap(m_worldList);
+    m_prevFrame = m_frame;
+    // 所有坐标都是画布上的原始像素
+    m_worldList.begin();
+
     QPointF viewOffsetMap(0, 0);
     QPointF viewOffset(0, 0);
     QRectF gameWorldClipRect;
     if (m_gameMap && m_gameMap->getWidth() > 0) {
-        double worldContentWidth = (m_gameMap->getWidth() * 16) * SCALE;
-        double worldContentHeight = (m_gameMap->getHeight() * 16) * SCALE;
-        double offsetX = (this->width() - worldContentWidth) / 2.0;
-        double offsetY = (this->height() - worldContentHeight) / 2.0;
+        // 偏移取整，画布上的精灵都落在整像素上
+        int worldContentWidth = m_gameMap->getWidth() * 16;
+        int worldContentHeight = m_gameMap->getHeight() * 16;
+        int offsetX = (m_canvasSize.width() - worldContentWidth) / 2;
+        int offsetY = (m_canvasSize.height() - worldContentHeight) / 2;
         viewOffset.setX(offsetX);
         viewOffset.setY(offsetY);
         viewOffsetMap = viewOffset;
@@ -192,162 +236,316 @@ void GameWidget::paintEvent(QPaintEvent *event) {
         viewOffsetMap.setX(m_transitionStartOffset.x());
         viewOffsetMap.setY(currentOffsetY);
     }
-    painter.fillRect(rect(), Qt::black); 
-    if (m_lightningEffectTimer > 0) {
-        QRect lightningSourceRect_1 = SpriteManager::instance().getSpriteRect("lightning_2");
-        QRect lightningSourceRect_2 = SpriteManager::instance().getSpriteRect("lightning_1");
-        if (lightningSourceRect_1.isNull()) return;
-        for (int i = 0; i < m_lightningSegments.size(); ++i) {
-            const QPointF& segmentPos = m_lightningSegments[i];
-            QRect currentSourceRect;
-            if (i % 2 == 0) {
-                currentSourceRect = lightningSourceRect_1;
-            } else {
-                currentSourceRect = lightningSourceRect_2.isNull() ? lightningSourceRect_1 : lightningSourceRect_2;
+    m_frame.viewOffsetMap = viewOffsetMap;
+    m_frame.worldClipRect = gameWorldClipRect;
+    m_frame.showNextMap = m_isTransitioning && m_nextMap;
+    if (m_frame.showNextMap) {
+        double mapHeight = m_gameMap->getHeight() * 16;
+        m_frame.nextMapOffset = viewOffsetMap + QPointF(0, mapHeight);
+    }
+    m_frame.map = m_gameMap;
+    m_frame.mapVersion = m_gameMap ? m_gameMap->getLayoutVersion() : -1;
+    m_frame.lightningOnly = m_lightningEffectTimer > 0;
+    updateHud(viewOffset, gameWorldClipRect);
+
+    if (m_frame.lightningOnly) {
+        int lightningSprite_1 = m_sprites.lightning2;
+        int lightningSprite_2 = m_sprites.lightning1;
+        if (!SpriteManager::instance().getSpriteRect(lightningSprite_1).isNull()) {
+            if (SpriteManager::instance().getSpriteRect(lightningSprite_2).isNull()) lightningSprite_2 = lightningSprite_1;
+            for (int i = 0; i < m_lightningSegments.size(); ++i) {
+                int currentSprite = (i % 2 == 0) ? lightningSprite_1 : lightningSprite_2;
+                m_worldList.add(currentSprite, m_lightningSegments[i] + viewOffsetMap, DrawLayer::Effect);
             }
-            QPointF destinationAnchor = segmentPos * SCALE;
-            QRectF destRect(destinationAnchor, currentSourceRect.size() * SCALE);
-            destRect.translate(viewOffsetMap);
-            painter.drawPixmap(destRect, m_spriteSheet, currentSourceRect);
+            player->paint(m_worldList, viewOffsetMap);
         }
-        player->paint(&painter, m_spriteSheet, viewOffsetMap);
+        m_worldList.end();
         return;
     }
-    painter.setClipRect(gameWorldClipRect);
-    if (m_gameMap) m_gameMap->paint(&painter, m_spriteSheet, viewOffsetMap);
-    if (m_isTransitioning && m_nextMap) {
-        double mapHeight = (m_gameMap->getHeight() * 16) * SCALE;
-        QPointF nextMapOffset = viewOffsetMap + QPointF(0, mapHeight);
-        m_nextMap->paint(&painter, m_spriteSheet, nextMapOffset);
-    }
-    for (auto it: m_deadmonsters) it->paint(&painter, m_spriteSheet, viewOffsetMap);
-    vendor->paint(&painter, m_spriteSheet, viewOffsetMap);
-    for (auto it: m_items) it->paint(&painter, m_spriteSheet, viewOffsetMap);
-    player->paint(&painter, m_spriteSheet, viewOffsetMap);
+    if (m_gameMap) m_gameMap->collectSprites(m_worldList, viewOffsetMap);
+    if (m_frame.showNextMap) m_nextMap->collectSprites(m_worldList, m_frame.nextMapOffset);
+    m_particles.collectSprites(m_worldList, viewOffsetMap);
+    vendor->paint(m_worldList, viewOffsetMap);
+    for (auto it: m_items) it->paint(m_worldList, viewOffsetMap);
+    player->paint(m_worldList, viewOffsetMap);
     if (player->getState() == PlayerState::Lifting) {
         if (m_purchasedItem) {
-            m_purchasedItem->paint(&painter, m_spriteSheet, viewOffsetMap);
+            m_purchasedItem->paint(m_worldList, viewOffsetMap);
         } else {
             qWarning() << "GameWidget: m_purchasedItem is null during painting.";
         }
     }
-    for (MonsterEntity* monster : m_monsters) monster->paint(&painter, m_spriteSheet, viewOffsetMap); 
-    QRect bulletSourceRect = SpriteManager::instance().getSpriteRect("player_bullet_1");
+    for (MonsterEntity* monster : m_monsterDrawOrder) monster->paint(m_worldList, viewOffsetMap);
+    QRect bulletSourceRect = SpriteManager::instance().getSpriteRect(m_sprites.bullet);
     if (!bulletSourceRect.isNull()) {
+        QPointF bulletCenterOffset = QPointF(10, 10) - QPointF(bulletSourceRect.width()/2.0, bulletSourceRect.height()/2.0);
         for (const auto& bullet : m_bullets) {
-            // qDebug() << "bullet";
-            QPointF topLeft = (bullet.position - QPointF(bulletSourceRect.width()/2.0, bulletSourceRect.height()/2.0) + QPointF(10, 10)) * SCALE;
-            // qDebug() << bullet.position;
-            QSizeF scaledSize(bulletSourceRect.width() * SCALE, bulletSourceRect.height() * SCALE);
-            QRectF destRect(topLeft, scaledSize);
-            destRect.translate(viewOffsetMap);
-            painter.drawPixmap(destRect, m_spriteSheet, bulletSourceRect);
+            m_worldList.add(m_sprites.bullet, bullet.position + bulletCenterOffset + viewOffsetMap, DrawLayer::Bullet);
         }
     }
-    painter.setClipping(false); 
-    paintUi(&painter, viewOffset, gameWorldClipRect);
-}
-
-void GameWidget::paintUi(QPainter *painter, const QPointF& viewOffset, const QRectF& mapRect) {
+    m_worldList.end();
+}
+
+void GameWidget::updateHud(const QPointF& viewOffset, const QRectF& mapRect) {
+    // 界面内容没变时沿用上次的命令和文字，只更新进度条
+    HudKey key;
+    key.viewOffset = viewOffset;
+    key.mapRect = mapRect;
+    key.health = m_healthCount;
+    key.money = m_moneyCount;
+    key.possessedItemType = m_hasPossessedItem ? m_possessedItemType : -1;
+    key.transitioning = m_isTransitioning;
+    key.showTimeBar = m_maxTime > 0;
+    bool upgradesChanged = m_hudKey.upgrades.size() != ui_items.size()
+        || !std::equal(m_hudKey.upgrades.cbegin(), m_hudKey.upgrades.cend(), ui_items.keyBegin());
+    if (m_frame.hudVersion == 0 || upgradesChanged || !key.sameLayout(m_hudKey)) {
+        key.upgrades = ui_items.keys();
+        m_hudKey = key;
+        m_prevUiList.swap(m_uiList);
+        m_uiList.begin();
+        m_frame.hud = HudFrame();
+        buildUi(viewOffset, mapRect);
+        m_uiList.end();
+        m_frame.hud.bounds = m_uiList.boundingRect();
+        m_frame.hudVersion++;
+    }
+    HudFrame& hud = m_frame.hud;
+    if (hud.showTimeBar) {
+        // 按整像素记录，进度条没有肉眼可见的变化时不用重画
+        hud.timeBarFill = qRound(hud.timeBarRect.width() * (m_currentTime / m_maxTime));
+    }
+}
+
+void GameWidget::buildUi(const QPointF& viewOffset, const QRectF& mapRect) {
     double ui_margin = 3.0;
+    HudFrame& hud = m_frame.hud;
 
-    QRect itemRect = SpriteManager::instance().getSpriteRect("ui_item_ground");
-    QRectF itemRectF(-(itemRect.width() + ui_margin)*SCALE, 0, itemRect.width()*SCALE, itemRect.height()*SCALE);
+    QRect itemRect = SpriteManager::instance().getSpriteRect(m_sprites.itemGround);
+    QRectF itemRectF(-(itemRect.width() + ui_margin), 0, itemRect.width(), itemRect.height());
     QPointF itemBottomLeft = itemRectF.bottomLeft();
     itemRectF.translate(viewOffset);
-    painter->drawPixmap(itemRectF, m_spriteSheet, itemRect);
+    m_uiList.add(m_sprites.itemGround, itemRectF.topLeft(), DrawLayer::Ui);
     if (m_hasPossessedItem) {
-        QString itemSpriteName = ItemEntity::typeToString(static_cast<int>(m_possessedItemType));
-        QRect itemSourceRect = SpriteManager::instance().getSpriteRect(itemSpriteName);
+        int itemSpriteId = ItemEntity::typeToSpriteId(static_cast<int>(m_possessedItemType));
+        QRect itemSourceRect = SpriteManager::instance().getSpriteRect(itemSpriteId);
         if (!itemSourceRect.isNull()) {
             double itemScaleRatio = 0.8; 
             double itemScaledWidth = itemRectF.width() * itemScaleRatio;
             double itemScaledHeight = itemRectF.height() * itemScaleRatio;
-            QSizeF itemScaledSize(itemScaledWidth, itemScaledHeight);
             QPointF itemTopLeft = itemRectF.center() - QPointF(itemScaledWidth / 2.0, itemScaledHeight / 2.0);
-            QRectF itemDestRect(itemTopLeft, itemScaledSize);
-            painter->drawPixmap(itemDestRect, m_spriteSheet, itemSourceRect);
+            m_uiList.add(itemSpriteId, itemTopLeft, DrawLayer::Ui, itemScaledWidth / itemSourceRect.width());
         }
     }
 
-    QRect healthRect = SpriteManager::instance().getSpriteRect("ui_helth");
-    QRectF healthRectF(itemBottomLeft.x()-ui_margin*SCALE, (itemBottomLeft.y() + ui_margin*SCALE), healthRect.width()*SCALE, healthRect.height()*SCALE);
+    QRect healthRect = SpriteManager::instance().getSpriteRect(m_sprites.health);
+    QRectF healthRectF(itemBottomLeft.x()-ui_margin, (itemBottomLeft.y() + ui_margin), healthRect.width(), healthRect.height());
     QPointF healthBottomLeft = healthRectF.bottomLeft();
     healthRectF.translate(viewOffset);
-    painter->drawPixmap(healthRectF, m_spriteSheet, healthRect);
+    m_uiList.add(m_sprites.health, healthRectF.topLeft(), DrawLayer::Ui);
 
-    QRect moneyRect = SpriteManager::instance().getSpriteRect("ui_money");
-    QRectF moneyRectF(healthBottomLeft.x(), (healthBottomLeft.y() + ui_margin*SCALE), moneyRect.width()*SCALE, moneyRect.height()*SCALE);
+    QRect moneyRect = SpriteManager::instance().getSpriteRect(m_sprites.money);
+    QRectF moneyRectF(healthBottomLeft.x(), (healthBottomLeft.y() + ui_margin), moneyRect.width(), moneyRect.height());
     moneyRectF.translate(viewOffset);
-    painter->drawPixmap(moneyRectF, m_spriteSheet, moneyRect);
+    m_uiList.add(m_sprites.money, moneyRectF.topLeft(), DrawLayer::Ui);
 
     if(!m_isTransitioning) {    
-        QRect circleRect = SpriteManager::instance().getSpriteRect("ui_circle");
-        QRectF circleRectF(0, -(circleRect.height()+ui_margin/4)*SCALE, circleRect.width()*SCALE , circleRect.height()*SCALE);
+        QRect circleRect = SpriteManager::instance().getSpriteRect(m_sprites.circle);
+        QRectF circleRectF(0, -(circleRect.height()+ui_margin/4), circleRect.width(), circleRect.height());
         circleRectF.translate(viewOffset);
-        painter->drawPixmap(circleRectF, m_spriteSheet, circleRect);
+        m_uiList.add(m_sprites.circle, circleRectF.topLeft(), DrawLayer::Ui);
         if (m_maxTime > 0) { 
-            double barWidth = 15*16*SCALE; 
-            double barHeight = 4*SCALE; 
-            QColor barBackgroundColor = Qt::darkGray;
-            QColor barFillColor = Qt::green;
+            double barWidth = 15*16; 
+            double barHeight = 4; 
             QPointF barTopLeft(
-                circleRectF.right() + (ui_margin/2)*SCALE, 
-                circleRectF.center().y() - barHeight / 2.0 + 3 * SCALE
+                circleRectF.right() + (ui_margin/2), 
+                circleRectF.center().y() - barHeight / 2.0 + 3
             );
-            QRectF barBackgroundRect(barTopLeft, QSizeF(barWidth, barHeight));
-            double timeRatio = m_currentTime / m_maxTime;
-            double fillWidth = barWidth * timeRatio;
-            QRectF barFillRect(barTopLeft, QSizeF(fillWidth, barHeight));
-            painter->fillRect(barBackgroundRect, barBackgroundColor);
-            painter->fillRect(barFillRect, barFillColor);
-            painter->setPen(Qt::black);
-            painter->drawRect(barBackgroundRect);
+            hud.showTimeBar = true;
+            hud.timeBarRect = QRectF(barTopLeft, QSizeF(barWidth, barHeight));
         }
     }
-    QString healthText = QString("x%1").arg(m_healthCount-1);
-    QFont Hfont = painter->font();
-    Hfont.setPointSize(16); 
-    painter->setFont(Hfont);
-    painter->setPen(Qt::white);
-    QPointF healthtextPos(
-        healthRectF.right() + (ui_margin/10) * SCALE, 
-        healthRectF.center().y() + Hfont.pointSize() / 2.0 
+
+    // 文字按原始像素排版算出位置和脏矩形，真正绘制时按放大倍数放大字号
+    QFont hudFont = font();
+    hudFont.setPixelSize(HUD_FONT_PIXELS);
+    QFontMetricsF metrics(hudFont);
+    hud.healthText = QString("x%1").arg(m_healthCount-1);
+    hud.healthTextPos = QPointF(
+        healthRectF.right() + (ui_margin/10), 
+        healthRectF.center().y() + HUD_FONT_PIXELS / 2.0 
     );
-    painter->drawText(healthtextPos, healthText);
-
-    QString moneyText = QString("x%1").arg(m_moneyCount);
-    QFont Mfont = painter->font();
-    Mfont.setPointSize(16); 
-    painter->setFont(Mfont);
-    painter->setPen(Qt::white); 
-    QPointF moneyTextPos(
-        moneyRectF.right() + (ui_margin/10) * SCALE, 
-        moneyRectF.center().y() + Mfont.pointSize() / 2.0 
+    hud.healthTextRect = metrics.boundingRect(hud.healthText).translated(hud.healthTextPos).adjusted(-1, -1, 1, 1);
+    hud.moneyText = QString("x%1").arg(m_moneyCount);
+    hud.moneyTextPos = QPointF(
+        moneyRectF.right() + (ui_margin/10), 
+        moneyRectF.center().y() + HUD_FONT_PIXELS / 2.0 
     );
-    painter->drawText(moneyTextPos, moneyText);
+    hud.moneyTextRect = metrics.boundingRect(hud.moneyText).translated(hud.moneyTextPos).adjusted(-1, -1, 1, 1);
+
     if (!ui_items.isEmpty()) {
         double marginFromMap = 3;
         QPointF anchorPoint = mapRect.bottomLeft();
         int index = 0;
         for (const auto& item : ui_items) {
             if (!item) continue;
-            QString itemName = item->typeToString(item->getType());
-            QRect itemSourceRect = SpriteManager::instance().getSpriteRect(itemName);
+            int itemSpriteId = ItemEntity::typeToSpriteId(item->getType());
+            QRect itemSourceRect = SpriteManager::instance().getSpriteRect(itemSpriteId);
             if (!itemSourceRect.isNull()) {
-                QSizeF itemScaledSize(itemSourceRect.width() * SCALE, itemSourceRect.height() * SCALE);
+                QSizeF itemScaledSize(itemSourceRect.width(), itemSourceRect.height());
                 QPointF itemTopLeft(
                     anchorPoint.x() - marginFromMap - itemScaledSize.width(),
                     anchorPoint.y() - itemScaledSize.height() - (index * (itemScaledSize.height() + marginFromMap))
                 );
-                QRectF itemDestRect(itemTopLeft, itemScaledSize);
-                painter->drawPixmap(itemDestRect, m_spriteSheet, itemSourceRect);
+                m_uiList.add(itemSpriteId, itemTopLeft, DrawLayer::Ui);
                 index++;
             }
         }
     }
 }
 
+void GameWidget::scheduleRepaint() {
+    // 转场时整张地图在滚动，闪电特效开始和结束时画面整体切换，这些情况直接全部重画
+    bool fullRepaint = m_fullRepaint
+        || m_isTransitioning || m_prevFrame.showNextMap
+        || m_frame.lightningOnly != m_prevFrame.lightningOnly
+        || m_frame.map != m_prevFrame.map || m_frame.mapVersion != m_prevFrame.mapVersion
+        || m_frame.viewOffsetMap != m_prevFrame.viewOffsetMap;
+    if (fullRepaint) {
+        m_fullRepaint = false;
+        queueRender(QRegion(), true);
+        return;
+    }
+    m_dirtyRects.clear();
+    QRect worldClip = m_frame.worldClipRect.toAlignedRect();
+    m_worldList.addChangedRects(m_prevWorldList, m_dirtyRects);
+    if (!m_frame.lightningOnly) {
+        // 地图外的部分被裁掉，不用重画
+        for (QRect& rect : m_dirtyRects) rect = rect.intersected(worldClip);
+    }
+    const HudFrame& hud = m_frame.hud;
+    const HudFrame& prevHud = m_prevFrame.hud;
+    if (m_frame.hudVersion != m_prevFrame.hudVersion) {
+        m_uiList.addChangedRects(m_prevUiList, m_dirtyRects);
+        if (hud.healthText != prevHud.healthText || hud.healthTextRect != prevHud.healthTextRect) {
+            m_dirtyRects.append(prevHud.healthTextRect.toAlignedRect());
+            m_dirtyRects.append(hud.healthTextRect.toAlignedRect());
+        }
+        if (hud.moneyText != prevHud.moneyText || hud.moneyTextRect != prevHud.moneyTextRect) {
+            m_dirtyRects.append(prevHud.moneyTextRect.toAlignedRect());
+            m_dirtyRects.append(hud.moneyTextRect.toAlignedRect());
+        }
+    }
+    if (hud.showTimeBar != prevHud.showTimeBar || hud.timeBarFill != prevHud.timeBarFill || hud.timeBarRect != prevHud.timeBarRect) {
+        // 边框画在矩形外沿，多留一个像素
+        m_dirtyRects.append(prevHud.timeBarRect.toAlignedRect().adjusted(-1, -1, 1, 1));
+        m_dirtyRects.append(hud.timeBarRect.toAlignedRect().adjusted(-1, -1, 1, 1));
+    }
+
+    QRegion dirty;
+    for (const QRect& rect : m_dirtyRects) {
+        if (!rect.isEmpty()) dirty += rect;
+    }
+    if (dirty.isEmpty()) return; // 画面没有变化，这一帧不重画
+    queueRender(dirty, false);
+}
+
+void GameWidget::queueRender(const QRegion& dirty, bool fullRepaint) {
+    // 渲染线程还在画上一帧时只累积脏区域，画完后用最新的命令一起补画
+    m_pendingDirty += dirty;
+    m_pendingFull = m_pendingFull || fullRepaint;
+    m_hasPendingFrame = true;
+    if (!m_renderBusy) dispatchFrame();
+}
+
+void GameWidget::dispatchFrame() {
+    RenderFrame frame = captureFrame(m_pendingFull ? QRegion() : m_pendingDirty);
+    m_dispatchedHud = frame.hud;
+    m_dispatchedScale = m_pixelScale;
+    m_dispatchedLightningOnly = frame.lightningOnly;
+    m_pendingDirty = QRegion();
+    m_pendingFull = false;
+    m_hasPendingFrame = false;
+    m_renderBusy = true;
+    FrameRenderer* renderer = m_renderer;
+    QMetaObject::invokeMethod(renderer, [renderer, frame]() { renderer->render(frame); }, Qt::QueuedConnection);
+}
+
+RenderFrame GameWidget::captureFrame(const QRegion& dirty) {
+    RenderFrame frame;
+    frame.size = m_canvasSize;
+    frame.atlas = m_atlas;
+    frame.world = m_worldList;
+    frame.ui = m_uiList;
+    if (m_gameMap) frame.mapLayer = m_gameMap->staticLayer(m_atlas);
+    if (m_frame.showNextMap && m_nextMap) frame.nextMapLayer = m_nextMap->staticLayer(m_atlas);
+    frame.mapOffset = m_frame.viewOffsetMap;
+    frame.nextMapOffset = m_frame.nextMapOffset;
+    frame.worldClipRect = m_frame.worldClipRect;
+    frame.lightningOnly = m_frame.lightningOnly;
+    frame.hud = m_frame.hud;
+    frame.hudVersion = m_frame.hudVersion;
+    frame.dirty = dirty;
+    return frame;
+}
+
+void GameWidget::onFrameReady(const QImage& image, const QRegion& dirty) {
+    m_frameImage = image;
+    m_frameHud = m_dispatchedHud;
+    m_frameScale = m_dispatchedScale;
+    m_frameLightningOnly = m_dispatchedLightningOnly;
+    m_renderBusy = false;
+    // 脏区域是画布上的原始像素，换算成窗口坐标；倍数不是整数逻辑像素时向外取整
+    qreal scale = m_frameScale / devicePixelRatioF();
+    QRegion windowDirty;
+    for (const QRect& rect : dirty) {
+        windowDirty += QRectF(rect.x() * scale, rect.y() * scale, rect.width() * scale, rect.height() * scale).toAlignedRect();
+    }
+    update(windowDirty);
+    if (m_hasPendingFrame) dispatchFrame();
+}
+
+void GameWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    m_fullRepaint = true;
+    renderFrame();
+}
+
+void GameWidget::paintEvent(QPaintEvent *event) {
+    // 画面由渲染线程按原始像素画好，这里只放大贴图和画文字
+    QPainter painter(this);
+    if (m_frameImage.isNull()) {
+        painter.fillRect(event->rect(), Qt::black);
+        return;
+    }
+    qreal scale = m_frameScale / devicePixelRatioF();
+    QRectF imageRect(QPointF(0, 0), QSizeF(m_frameImage.size()) * scale);
+    if (!imageRect.contains(event->rect())) {
+        // 窗口刚变大，新一帧还没画好
+        painter.fillRect(event->rect(), Qt::black);
+    }
+    presentFrame(&painter, m_frameImage, m_frameHud, m_frameLightningOnly, scale);
+}
+
+void GameWidget::presentFrame(QPainter* painter, const QImage& frame, const HudFrame& hud, bool lightningOnly, qreal scale) {
+    // 整张画布只做这一次缩放，关掉平滑就是最近邻；按物理像素算倍数是整数，像素边缘不会糊
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(QRectF(QPointF(0, 0), QSizeF(frame.size()) * scale), frame);
+    // 闪电特效期间和界面精灵一样不画计数文字
+    if (lightningOnly) return;
+
+    // 计数文字放大之后再画，字号跟着倍数走，文字保持清晰
+    QFont hudFont = font();
+    hudFont.setPixelSize(qMax(1, qRound(HUD_FONT_PIXELS * scale)));
+    if (m_healthText.text() != hud.healthText) m_healthText.setText(hud.healthText);
+    if (m_moneyText.text() != hud.moneyText) m_moneyText.setText(hud.moneyText);
+    // drawText的位置是基线，drawStaticText的位置是左上角
+    QPointF baselineToTop(0, -QFontMetricsF(hudFont).ascent());
+    painter->setFont(hudFont);
+    painter->setPen(Qt::white);
+    painter->drawStaticText(hud.healthTextPos * scale + baselineToTop, m_healthText);
+    painter->drawStaticText(hud.moneyTextPos * scale + baselineToTop, m_moneyText);
+}
+
 void GameWidget::keyPressEvent(QKeyEvent *event) {    
     keys[event->key()] = true;
     QWidget::keyPressEvent(event);
@@ -359,7 +557,7 @@ void GameWidget::keyReleaseEvent(QKeyEvent *event) {
     QWidget::keyReleaseEvent(event);
 }
 
-void GameWidget::timerEvent() {
+void GameWidget::processInput() {
     if (keys[Qt::Key_P] && !m_pauseKeyPressed) {
         m_pauseKeyPressed = true;
         m_isGamePaused = !m_isGamePaused;
@@ -462,26 +660,17 @@ void GameWidget::timerEvent() {
 }
 
 void GameWidget::syncEnemies() {
-    QSet<int> liveEnemyIds;
+    // 本次同步到的怪物打上新的帧号，最后帧号没变的就是已经消失的
+    m_enemySyncStamp++;
+    m_monsterDrawOrder.clear();
     for (const auto& data : m_enemyDataList) {
-        liveEnemyIds.insert(data.id);
-    }
-    for (auto it = m_monsters.begin(); it != m_monsters.end();) {
-        if (!liveEnemyIds.contains(it.key())) {
-            delete it.value();
-            it = m_monsters.erase(it);
-        } else {
-            ++it;
-        }
-    }
-    for (const auto& data : m_enemyDataList) {
-        MonsterEntity* monster = nullptr;
-        if (!m_monsters.contains(data.id)) {
-            monster = new MonsterEntity(enemyTypeToMonsterType(data.enemyType));
-            m_monsters[data.id] = monster;
-        } else {
-            monster = m_monsters[data.id];
+        MonsterEntity*& monster = m_monsters[data.id];
+        if (!monster) {
+            monster = m_monsterPool.acquire();
+            monster->spawn(enemyTypeToMonsterType(data.enemyType));
         }
+        monster->syncStamp = m_enemySyncStamp;
+        m_monsterDrawOrder.append(monster);
         monster->setPosition(data.position);
         monster->setVelocity(data.velocity);
         
@@ -493,6 +682,14 @@ void GameWidget::syncEnemies() {
         // 根据玩家潜行状态设置敌人是否冻结
         monster->setFrozen(m_playerStealthMode);
     }
+    for (auto it = m_monsters.begin(); it != m_monsters.end();) {
+        if (it.value()->syncStamp != m_enemySyncStamp) {
+            m_monsterPool.release(it.value());
+            it = m_monsters.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 void GameWidget::syncItems() {
@@ -519,16 +716,17 @@ void GameWidget::syncItems() {
         }
         if (item->getState() != ItemState::Picked) {
             item->setPosition(data.position);
-            item->setLingerTimer(data.remainTime);
+            item->setLingerTimer(data.expireTime - m_itemTime);
         }
     }
 }
 
 void GameWidget::die(int id) {
     // qDebug() << "ID: " << id << "die";
-    if (m_monsters.contains(id)) {
-        DeadMonsterEntity* deadm = new DeadMonsterEntity(*m_monsters.value(id));
-        m_deadmonsters.insert(id, deadm);
+    MonsterEntity* monster = m_monsters.value(id, nullptr);
+    if (monster) {
+        // 尸体播完死亡动画后再停留20秒
+        m_particles.spawn(ParticleKind::Corpse, monster->deathClip(), monster->getPosition(), DrawLayer::Corpse, 20.0);
     }
 }
 
@@ -536,7 +734,7 @@ void GameWidget::updateGameTime(double gameTime) {
     m_currentTime = 60 - gameTime;
 }
 
-void GameWidget::updateBullets(QList<BulletData> bullets) {
+void GameWidget::updateBullets(BulletView bullets) {
     m_bullets = bullets;
 }
 
@@ -544,8 +742,9 @@ void GameWidget::updateEnemies(QList<EnemyData> enemies) {
     m_enemyDataList = enemies;
 }
 
-void GameWidget::updateItems(QList<ItemData> items) {
+void GameWidget::updateItems(ItemView items, double itemTime) {
     m_itemDataList = items;
+    m_itemTime = itemTime;
 }
 
 void GameWidget::updatePlayerStealthMode(bool isStealth) {
@@ -608,7 +807,7 @@ void GameWidget::updateSmoke(double deltaTime) {
     if (m_nextSmokeReleaseTimer <= 0) {
         double randX = QRandomGenerator::global()->bounded(16) + player->getPosition().x();
         double randY = QRandomGenerator::global()->bounded(16) + player->getPosition().y();
-        m_gameMap->createExplosion(QPointF(randX, randY));
+        spawnExplosion(QPointF(randX, randY));
         m_nextSmokeReleaseTimer = (QRandomGenerator::global()->bounded(150) + 150) / 1000.0;
     }
 }
@@ -626,11 +825,16 @@ void GameWidget::updateExplosion(double deltaTime) {
     if (m_nextExplosionSpawnTimer <= 0) {
         double randX = QRandomGenerator::global()->bounded((m_gameMap->getWidth()-1) * 16);
         double randY = QRandomGenerator::global()->bounded((m_gameMap->getHeight()-1) * 16);
-        m_gameMap->createExplosion(QPointF(randX, randY));
+        spawnExplosion(QPointF(randX, randY));
         m_nextExplosionSpawnTimer = (QRandomGenerator::global()->bounded(150) + 0) / 1000.0;
     }
 }
 
+void GameWidget::spawnExplosion(const QPointF& position) {
+    static const AnimationClip* explodeClip = SpriteManager::instance().getAnimationClip("explode", 6.0, false);
+    m_particles.spawn(ParticleKind::Effect, explodeClip, position, DrawLayer::Map);
+}
+
 void GameWidget::startExplosionSequence(double duration) {
     m_isExplosionSequenceActive = true;
     m_explosionSequenceTimer = duration;
@@ -648,6 +852,7 @@ void GameWidget::purchase(int itemType) {
     m_pausedTime = 0.5;  
     m_isGamePaused = true;
     m_purchasedItem = new ItemEntity(itemType);
+    m_purchasedItem->setDrawLayer(DrawLayer::HeldItem);
     if (itemType == 12 || itemType == 14 || itemType == 15 || itemType == 17 || itemType == 18) {
         ui_items.remove(itemType-1);
     }
@@ -732,31 +937,35 @@ void GameWidget::onGameWin() {
     qDebug() << "游戏胜利，清除所有游戏元素";
     
     // 清除所有敌人
-    qDeleteAll(m_monsters);
-    m_monsters.clear();
-    qDeleteAll(m_deadmonsters);
-    m_deadmonsters.clear();
+    releaseMonsters();
     
     // 清除所有道具
     qDeleteAll(m_items);
     m_items.clear();
     
     // 清除所有子弹数据
-    m_bullets.clear();
+    m_bullets = BulletView();
     
     // 清除所有敌人数据
     m_enemyDataList.clear();
     
     // 清除所有道具数据
-    m_itemDataList.clear();
+    m_itemDataList = ItemView();
     
     // 加载游戏胜利地图
-    m_gameMap->loadFromFile(":/assert/picture/gamemap.json", "end", "1");
+    m_gameMap->loadLayout("end", "1");
     m_gameMap->setMapTitle("end");
     m_isGamePaused = true;
     emit gameWin(); 
 }
 
+void GameWidget::releaseMonsters() {
+    for (MonsterEntity* monster : m_monsters) m_monsterPool.release(monster);
+    m_monsters.clear();
+    m_monsterDrawOrder.clear();
+    m_particles.clear();
+}
+
 // 辅助函数：将EnemyData的enemyType转换为MonsterType
 MonsterType GameWidget::enemyTypeToMonsterType(int enemyType) {
     switch (enemyType) {
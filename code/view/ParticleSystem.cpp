@@ -0,0 +1,82 @@
+#include "view/ParticleSystem.h"
+
+ParticleSystem::ParticleSystem()
+    : m_x(CAPACITY), m_y(CAPACITY), m_frameTime(CAPACITY), m_linger(CAPACITY),
+      m_frameIndex(CAPACITY), m_clip(CAPACITY), m_layer(CAPACITY), m_kind(CAPACITY) {
+}
+
+void ParticleSystem::spawn(ParticleKind kind, const AnimationClip* clip, const QPointF& position, DrawLayer layer, double linger) {
+    if (!clip || clip->frameIds.isEmpty()) return;
+    int index = m_count;
+    if (kind == ParticleKind::Corpse && m_kindCount[static_cast<int>(kind)] >= CORPSE_BUDGET) {
+        // 尸体满了，原地替换最快要消失的那个，数量不变
+        index = evictCorpse();
+    } else if (kind == ParticleKind::Effect && m_kindCount[static_cast<int>(kind)] >= EFFECT_BUDGET) {
+        return;
+    } else {
+        m_count++;
+        m_kindCount[static_cast<int>(kind)]++;
+    }
+    m_x[index] = position.x();
+    m_y[index] = position.y();
+    m_frameTime[index] = 0.0f;
+    m_linger[index] = linger;
+    m_frameIndex[index] = 0;
+    m_clip[index] = clip;
+    m_layer[index] = layer;
+    m_kind[index] = kind;
+}
+
+int ParticleSystem::evictCorpse() const {
+    int victim = -1;
+    for (int i = 0; i < m_count; ++i) {
+        if (m_kind[i] != ParticleKind::Corpse) continue;
+        if (victim < 0 || m_linger[i] < m_linger[victim]) victim = i;
+    }
+    return victim;
+}
+
+void ParticleSystem::update(double deltaTime) {
+    // 一趟完成：播完的先扣停留时间，再推进一帧，最后把活着的往前挪
+    int alive = 0;
+    for (int i = 0; i < m_count; ++i) {
+        const AnimationClip* clip = m_clip[i];
+        if (isLastFrame(i)) {
+            m_linger[i] -= deltaTime;
+        } else if (clip->frameDuration > 0.0) {
+            m_frameTime[i] += deltaTime;
+            if (m_frameTime[i] >= clip->frameDuration) {
+                m_frameTime[i] -= clip->frameDuration;
+                m_frameIndex[i]++;
+            }
+        }
+        if (isLastFrame(i) && m_linger[i] <= 0.0f) {
+            m_kindCount[static_cast<int>(m_kind[i])]--;
+            continue;
+        }
+        if (alive != i) {
+            m_x[alive] = m_x[i];
+            m_y[alive] = m_y[i];
+            m_frameTime[alive] = m_frameTime[i];
+            m_linger[alive] = m_linger[i];
+            m_frameIndex[alive] = m_frameIndex[i];
+            m_clip[alive] = clip;
+            m_layer[alive] = m_layer[i];
+            m_kind[alive] = m_kind[i];
+        }
+        alive++;
+    }
+    m_count = alive;
+}
+
+void ParticleSystem::collectSprites(DrawList& drawList, const QPointF& viewOffset) const {
+    for (int i = 0; i < m_count; ++i) {
+        int spriteId = m_clip[i]->frameIds[m_frameIndex[i]];
+        drawList.addSprite(spriteId, QPointF(m_x[i], m_y[i]) + viewOffset, m_layer[i]);
+    }
+}
+
+void ParticleSystem::clear() {
+    m_count = 0;
+    for (int& count : m_kindCount) count = 0;
+}
@@ -0,0 +1,183 @@
+#include "view/RenderBenchmark.h"
+#include "view/GameWidget.h"
+#include "view/FrameRenderer.h"
+#include <QTextStream>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+const RenderBenchmark::Scene RenderBenchmark::SCENES[] = {
+    // 名字            怪物  子弹  爆炸   转场
+    {"empty",            0,    0, false, false},
+    {"monsters_10",     10,    0, false, false},
+    {"monsters_100",   100,    0, false, false},
+    {"monsters_1000", 1000,    0, false, false},
+    {"bullet_spam",     10,  512, false, false},
+    {"explosions",      10,    0, true,  false},
+    {"transition",       0,    0, false, true},
+};
+
+bool RenderBenchmark::isRequested(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--bench") == 0) return true;
+    }
+    return false;
+}
+
+int RenderBenchmark::run(const QStringList& arguments) {
+    int frames = 300;
+    QString goldenDir;
+    QStringList sceneNames;
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString& arg = arguments[i];
+        if (arg == "--frames" && i + 1 < arguments.size()) {
+            frames = qMax(1, arguments[++i].toInt());
+        } else if (arg == "--scene" && i + 1 < arguments.size()) {
+            sceneNames << arguments[++i];
+        } else if (arg == "--golden" && i + 1 < arguments.size()) {
+            goldenDir = arguments[++i];
+        }
+    }
+    if (!goldenDir.isEmpty() && !QDir().mkpath(goldenDir)) {
+        qWarning() << "[RenderBenchmark] 无法创建目录:" << goldenDir;
+        return 1;
+    }
+
+    int exitCode = 0;
+    bool ranAny = false;
+    for (const Scene& scene : SCENES) {
+        if (!sceneNames.isEmpty() && !sceneNames.contains(scene.name)) continue;
+        ranAny = true;
+        QImage lastFrame;
+        Timings timings = runScene(scene, frames, goldenDir.isEmpty() ? nullptr : &lastFrame);
+        report(scene.name, timings);
+        if (!goldenDir.isEmpty()) {
+            QString path = QDir(goldenDir).filePath(QString("%1.png").arg(scene.name));
+            if (!lastFrame.save(path)) {
+                qWarning() << "[RenderBenchmark] 保存失败:" << path;
+                exitCode = 1;
+            }
+        }
+    }
+    if (!ranAny) {
+        qWarning() << "[RenderBenchmark] 没有匹配的场景:" << sceneNames;
+        return 1;
+    }
+    return exitCode;
+}
+
+RenderBenchmark::Timings RenderBenchmark::runScene(const Scene& scene, int frames, QImage* lastFrame) {
+    // 固定窗口大小、步长和随机种子，每次运行的画面完全一样
+    const QSize windowSize(1280, 960);
+    const double deltaTime = 1.0 / 60;
+    QRandomGenerator random(20240601);
+
+    GameWidget widget;
+    widget.resize(windowSize);
+    // 转场的起止偏移按画布大小计算，第一次转场前先定下画布
+    widget.updateCanvasSize();
+
+    QList<EnemyData> enemies;
+    for (int i = 0; i < scene.monsterCount; ++i) {
+        EnemyData enemy;
+        enemy.id = i;
+        enemy.enemyType = i % 3;
+        enemy.position = QPointF(16 + random.bounded(224.0), 16 + random.bounded(224.0));
+        enemy.velocity = QPointF(random.bounded(80.0) - 40.0, random.bounded(80.0) - 40.0);
+        enemies.append(enemy);
+    }
+
+    // 子弹直接用一个本地的对象池，视图指向它
+    QVector<BulletData> bulletPool(scene.bulletCount);
+    QVector<int> bulletSlots(scene.bulletCount);
+    int bulletCount = scene.bulletCount;
+    for (int i = 0; i < scene.bulletCount; ++i) {
+        BulletData& bullet = bulletPool[i];
+        bullet.id = i;
+        bullet.position = QPointF(random.bounded(256.0), random.bounded(256.0));
+        double angle = random.bounded(6.2831853);
+        bullet.velocity = QPointF(qCos(angle), qSin(angle)) * 150.0;
+        bullet.isActive = true;
+        bullet.damage = 1;
+        bullet.lifetime = 10.0;
+        bulletSlots[i] = i;
+    }
+    widget.updateBullets(BulletView(bulletPool.constData(), bulletSlots.constData(), &bulletCount));
+
+    if (scene.explosions) widget.startExplosionSequence(frames * deltaTime);
+
+    FrameRenderer renderer;
+    QImage image;
+    // 放大后的窗口画面，和paintEvent画到窗口上的内容一样
+    QImage windowImage(windowSize, QImage::Format_ARGB32_Premultiplied);
+    QObject::connect(&renderer, &FrameRenderer::frameReady, [&image](const QImage& frame, const QRegion&) {
+        image = frame;
+    });
+
+    Timings timings;
+    timings.buildNs.reserve(frames);
+    timings.renderNs.reserve(frames);
+    timings.presentNs.reserve(frames);
+    QElapsedTimer timer;
+    int transitionCount = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        // 怪物在地图内来回移动，子弹出界后绕回来
+        for (EnemyData& enemy : enemies) {
+            enemy.position += enemy.velocity * deltaTime;
+            if (enemy.position.x() < 16 || enemy.position.x() > 240) enemy.velocity.rx() = -enemy.velocity.x();
+            if (enemy.position.y() < 16 || enemy.position.y() > 240) enemy.velocity.ry() = -enemy.velocity.y();
+        }
+        for (BulletData& bullet : bulletPool) {
+            bullet.position += bullet.velocity * deltaTime;
+            bullet.position.setX(std::fmod(bullet.position.x() + 256.0, 256.0));
+            bullet.position.setY(std::fmod(bullet.position.y() + 256.0, 256.0));
+        }
+        widget.updateEnemies(enemies);
+        widget.updateView(deltaTime);
+        // 转场只有两秒，结束后马上在两个布局之间来回转场，保证每个样本都是转场画面
+        if (scene.transition && !widget.m_isTransitioning) {
+            widget.startMapTransition("map_1", transitionCount++ % 2 == 0 ? "2" : "1");
+        }
+
+        timer.start();
+        widget.buildFrame();
+        RenderFrame renderFrame = widget.captureFrame(QRegion());
+        timings.buildNs.append(timer.nsecsElapsed());
+
+        // 整帧重画，相当于最坏情况下一次paintEvent的开销
+        timer.start();
+        renderer.render(renderFrame);
+        timings.renderNs.append(timer.nsecsElapsed());
+
+        // 原始像素的画布整数倍放大，再画计数文字
+        timer.start();
+        QPainter painter(&windowImage);
+        widget.presentFrame(&painter, image, renderFrame.hud, renderFrame.lightningOnly, widget.m_pixelScale);
+        painter.end();
+        timings.presentNs.append(timer.nsecsElapsed());
+    }
+    if (lastFrame) *lastFrame = windowImage;
+    return timings;
+}
+
+void RenderBenchmark::report(const char* sceneName, const Timings& timings) {
+    auto percentile = [](QVector<qint64> samples, double p) {
+        if (samples.isEmpty()) return 0.0;
+        std::sort(samples.begin(), samples.end());
+        int index = qBound(0, qCeil(p * samples.size()) - 1, static_cast<int>(samples.size()) - 1);
+        return samples[index] / 1000000.0;
+    };
+    QTextStream out(stdout);
+    out << QString("%1 frames=%2").arg(QString::fromLatin1(sceneName)).arg(timings.renderNs.size()) << Qt::endl;
+    const QVector<qint64>* parts[] = {&timings.buildNs, &timings.renderNs, &timings.presentNs};
+    const char* partNames[] = {"build", "render", "present"};
+    for (int i = 0; i < 3; ++i) {
+        out << QString("  %1 ms: p50=%2 p90=%3 p99=%4 max=%5")
+                   .arg(QString::fromLatin1(partNames[i]), -7)
+                   .arg(percentile(*parts[i], 0.50), 0, 'f', 3)
+                   .arg(percentile(*parts[i], 0.90), 0, 'f', 3)
+                   .arg(percentile(*parts[i], 0.99), 0, 'f', 3)
+                   .arg(percentile(*parts[i], 1.00), 0, 'f', 3)
+            << Qt::endl;
+    }
+}
@@ -0,0 +1,9 @@
+#include "view/SpriteAtlas.h"
+
+void SpriteAtlas::setSource(const QImage& spriteSheet) {
+    m_source = spriteSheet.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+void SpriteAtlas::draw(QPainter* painter, const QPointF& topLeft, const QRect& sourceRect) const {
+    painter->drawImage(topLeft, m_source, sourceRect);
+}
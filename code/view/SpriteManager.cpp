@@ -1,4 +1,5 @@
 #include "view/SpriteManager.h"
+#include <algorithm>
 
 SpriteManager& SpriteManager::instance() {
     static SpriteManager instance;
@@ -10,50 +11,213 @@ bool SpriteManager::loadFromFile(const QString& path) {
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) return false;
     QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    m_rootObject = doc.object();
-    
-    // 解析 "frames"
+    QJsonObject rootObject = doc.object();
+
+    m_spriteIds.clear();
     m_spriteRects.clear();
-    QJsonObject frames = m_rootObject["frames"].toObject();
+    m_spriteOrigins.clear();
+    m_compositeFirst.clear();
+    m_compositeCount.clear();
+    m_compositeParts.clear();
+    m_animationFrames.clear();
+
+    // 解析 "frames"，keys()是排好序的，同一份文件每次得到的ID都一样
+    QJsonObject frames = rootObject["frames"].toObject();
     for (const QString& key : frames.keys()) {
         QJsonObject frameData = frames[key].toObject();
-        m_spriteRects[key] = QRect(frameData["x"].toInt(), frameData["y"].toInt(), frameData["w"].toInt(), frameData["h"].toInt());
+        int id = internSprite(key);
+        m_spriteRects[id] = QRect(frameData["x"].toInt(), frameData["y"].toInt(), frameData["w"].toInt(), frameData["h"].toInt());
     }
 
-    // 解析 "composites"
-    m_composites.clear();
-    QJsonObject composites = m_rootObject["composites"].toObject();
+    // 解析 "composites"，和普通帧共用一套ID
+    QJsonObject composites = rootObject["composites"].toObject();
     for (const QString& key : composites.keys()) {
+        int id = internSprite(key);
+        m_compositeFirst[id] = m_compositeParts.size();
         QJsonArray compositeData = composites[key].toArray();
-        QList<SpritePart> parts;
         for (const QJsonValue& val : compositeData) {
             QJsonObject partData = val.toObject();
             SpritePart part;
-            part.frameName = partData["frame"].toString();
+            part.frameId = internSprite(partData["frame"].toString());
             part.offset.setX(partData["offset"].toObject()["x"].toInt());
             part.offset.setY(partData["offset"].toObject()["y"].toInt());
-            parts.append(part);
+            m_compositeParts.append(part);
+        }
+        m_compositeCount[id] = m_compositeParts.size() - m_compositeFirst[id];
+    }
+
+    // 解析 "animations"，帧名一次性转成ID，之后不再保留JSON
+    QJsonObject animations = rootObject["animations"].toObject();
+    for (auto it = animations.begin(); it != animations.end(); ++it) {
+        QVector<int> frameIds;
+        const QJsonArray animData = it.value().toArray();
+        frameIds.reserve(animData.size());
+        for (const QJsonValue& val : animData) {
+            frameIds.append(getSpriteId(val.toString()));
         }
-        m_composites[key] = parts;
+        m_animationFrames.insert(it.key(), frameIds);
     }
 
+    refreshClips();
     return true;
 }
 
-QRect SpriteManager::getSpriteRect(const QString& name) const {
-    return m_spriteRects.value(name, QRect());
+bool SpriteManager::loadFromPack(const AssetPack& pack) {
+    if (!pack.isOpen()) return false;
+    m_spriteIds.clear();
+    m_spriteRects.clear();
+    m_spriteOrigins.clear();
+    m_compositeFirst.clear();
+    m_compositeCount.clear();
+    m_compositeParts.clear();
+    m_animationFrames.clear();
+
+    // 记录按ID顺序存放，和打包时loadFromFile编出来的ID一致
+    const PackArray<AssetPackFormat::SpriteRecord> sprites = pack.sprites();
+    for (const AssetPackFormat::SpriteRecord& record : sprites) {
+        int id = internSprite(pack.string(record.name));
+        m_spriteRects[id] = QRect(record.x, record.y, record.width, record.height);
+        m_spriteOrigins[id] = QPoint(record.originX, record.originY);
+    }
+
+    const PackArray<qint32> frames = pack.animationFrames();
+    for (const AssetPackFormat::AnimationRecord& record : pack.animations()) {
+        if (record.firstFrame < 0 || record.frameCount < 0 || record.firstFrame + record.frameCount > frames.count) continue;
+        QVector<int> frameIds(frames.begin() + record.firstFrame, frames.begin() + record.firstFrame + record.frameCount);
+        m_animationFrames.insert(pack.string(record.name), frameIds);
+    }
+
+    refreshClips();
+    return sprites.count > 0;
+}
+
+void SpriteManager::refreshClips() {
+    // 已经发出去的片段原地换成新的帧列表
+    for (auto it = m_clipVariants.constBegin(); it != m_clipVariants.constEnd(); ++it) {
+        QVector<int> frameIds = m_animationFrames.value(it.key());
+        for (int index : it.value()) {
+            m_clips[index].frameIds = frameIds;
+        }
+    }
+}
+
+int SpriteManager::internSprite(const QString& name) {
+    auto it = m_spriteIds.constFind(name);
+    if (it != m_spriteIds.constEnd()) {
+        return it.value();
+    }
+    int id = m_spriteRects.size();
+    m_spriteIds.insert(name, id);
+    m_spriteRects.append(QRect());
+    m_spriteOrigins.append(QPoint());
+    m_compositeFirst.append(0);
+    m_compositeCount.append(0);
+    return id;
 }
 
-QList<SpritePart> SpriteManager::getCompositeParts(const QString& compositeName) const {
-    return m_composites.value(compositeName, QList<SpritePart>());
+int SpriteManager::getSpriteId(const QString& name) const {
+    return m_spriteIds.value(name, INVALID_ID);
 }
 
-QList<QString> SpriteManager::getAnimationSequence(const QString& animationName) const {
-    QJsonObject animations = m_rootObject["animations"].toObject();
-    QJsonArray animData = animations[animationName].toArray();
-    QList<QString> frameNames;
-    for (const QJsonValue& val : animData) {
-        frameNames.append(val.toString());
+QStringList SpriteManager::spriteNames() const {
+    QStringList names;
+    for (int id = 0; id < m_spriteRects.size(); ++id) names.append(QString());
+    for (auto it = m_spriteIds.constBegin(); it != m_spriteIds.constEnd(); ++it) {
+        names[it.value()] = it.key();
     }
-    return frameNames;
-}
\ No newline at end of file
+    return names;
+}
+
+QStringList SpriteManager::animationNames() const {
+    // 排好序，同一份sprite.json每次打出来的包都一样
+    QStringList names;
+    for (auto it = m_animationFrames.constBegin(); it != m_animationFrames.constEnd(); ++it) {
+        names.append(it.key());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+SpritePartList SpriteManager::getCompositeParts(int spriteId) const {
+    SpritePartList parts;
+    if (spriteId >= 0 && spriteId < m_compositeCount.size() && m_compositeCount[spriteId] > 0) {
+        parts.first = m_compositeParts.constData() + m_compositeFirst[spriteId];
+        parts.count = m_compositeCount[spriteId];
+    }
+    return parts;
+}
+
+QImage SpriteManager::bakeComposites(const QImage& spriteSheet) {
+    // 先算出每个复合精灵的包围盒，按行排在原精灵表下面，每个区域之间留1像素空隙
+    struct BakeSlot {
+        int id;
+        QRect bounds;       // 相对绘制位置的包围盒
+        QPoint position;    // 在扩展区域里的位置
+    };
+    QVector<BakeSlot> bakeSlots;
+    const int sheetWidth = spriteSheet.width();
+    int x = 0;
+    int y = spriteSheet.height() + 1;
+    int rowHeight = 0;
+    for (int id = 0; id < m_compositeCount.size(); ++id) {
+        if (m_compositeCount[id] == 0) continue;
+        QRect bounds;
+        for (const SpritePart& part : getCompositeParts(id)) {
+            bounds = bounds.united(QRect(part.offset, getSpriteRect(part.frameId).size()));
+        }
+        if (bounds.isEmpty()) continue;
+        if (x > 0 && x + bounds.width() > sheetWidth) {
+            x = 0;
+            y += rowHeight + 1;
+            rowHeight = 0;
+        }
+        bakeSlots.append({id, bounds, QPoint(x, y)});
+        x += bounds.width() + 1;
+        rowHeight = qMax(rowHeight, bounds.height());
+    }
+    if (bakeSlots.isEmpty()) return spriteSheet;
+
+    QImage baked(qMax(sheetWidth, bakeSlots.last().position.x() + bakeSlots.last().bounds.width()), y + rowHeight,
+                 QImage::Format_ARGB32_Premultiplied);
+    baked.fill(Qt::transparent);
+    QPainter painter(&baked);
+    painter.drawImage(0, 0, spriteSheet);
+    // 部件按定义顺序叠上去，和逐个绘制的结果一样
+    for (const BakeSlot& slot : bakeSlots) {
+        for (const SpritePart& part : getCompositeParts(slot.id)) {
+            QRect partRect = getSpriteRect(part.frameId);
+            if (partRect.isNull()) continue;
+            painter.drawImage(slot.position + part.offset - slot.bounds.topLeft(), spriteSheet, partRect);
+        }
+    }
+    painter.end();
+    for (const BakeSlot& slot : bakeSlots) {
+        m_spriteRects[slot.id] = QRect(slot.position, slot.bounds.size());
+        m_spriteOrigins[slot.id] = slot.bounds.topLeft();
+    }
+    qDebug() << "复合精灵合成完成，数量:" << bakeSlots.size() << "精灵表尺寸:" << baked.size();
+    return baked;
+}
+
+const AnimationClip* SpriteManager::getAnimationClip(const QString& animationName, double frameRate, bool loops) {
+    auto frames = m_animationFrames.constFind(animationName);
+    if (frames == m_animationFrames.constEnd()) return nullptr;
+    double frameDuration = frameRate > 0.0 ? 1.0 / frameRate : 0.0;
+    QVector<int>& variants = m_clipVariants[animationName];
+    for (int index : variants) {
+        const AnimationClip& clip = m_clips[index];
+        if (clip.frameDuration == frameDuration && clip.loops == loops) return &clip;
+    }
+    // 帧列表是隐式共享的，各个变体共用同一份数据
+    AnimationClip clip;
+    clip.frameIds = frames.value();
+    clip.frameDuration = frameDuration;
+    clip.loops = loops;
+    variants.append(static_cast<int>(m_clips.size()));
+    m_clips.push_back(clip);
+    return &m_clips.back();
+}
+
+QVector<int> SpriteManager::getAnimationSequence(const QString& animationName) const {
+    return m_animationFrames.value(animationName);
+}
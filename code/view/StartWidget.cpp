@@ -1,13 +1,19 @@
 #include "view/StartWidget.h"
+#include "common/AssetPack.h"
 
 StartWidget::StartWidget(QWidget *parent) : QWidget(parent)
 {
     this->setStyleSheet("background-color: black;"); 
 
     m_titleLabel = new QLabel(this);    
-    QPixmap fullSpriteSheet(":/assert/picture/sprite.png"); 
+    // 标题在精灵表左上角，资源包里合成后的精灵表上半部分就是原图，只拷贝这一小块
     QRect cropRect(0, 96, 94, 55);
-    QPixmap titlePixmap = fullSpriteSheet.copy(cropRect);
+    QPixmap titlePixmap;
+    if (AssetPack::instance().isOpen()) {
+        titlePixmap = QPixmap::fromImage(AssetPack::instance().atlas().copy(cropRect));
+    } else {
+        titlePixmap = QPixmap(":/assert/picture/sprite.png").copy(cropRect);
+    }
 
     int baseFontSize = 6; 
     int scaleFactor = 7; 
@@ -1,69 +1,105 @@
 #include "viewmodel/BulletViewModel.h"
 #include "viewmodel/CollisionSystem.h"
+#include <limits>
 
 BulletViewModel::BulletViewModel(QObject *parent)
     : QObject(parent) {
+    clearAllBullets();
 }
 BulletViewModel::~BulletViewModel() {
     clearAllBullets();
 }
 
 void BulletViewModel::createBullet(const QPointF& position, const QPointF& direction, double speed, int damage) {
-    BulletData bullet;
-    bullet.id = m_nextBulletId++;
+    spawnBullet(position, normalize(direction) * speed, damage);
+}
+
+void BulletViewModel::createBullets(const QPointF& position, const QPointF* directions, int count, double speed, int damage) {
+    for (int i = 0; i < count; ++i) {
+        spawnBullet(position, directions[i] * speed, damage);
+    }
+}
+
+void BulletViewModel::spawnBullet(const QPointF& position, const QPointF& velocity, int damage) {
+    if (m_freeCount == 0) {
+        qWarning() << "子弹池已满，丢弃子弹，容量:" << MAX_BULLETS;
+        return;
+    }
+    int slot = m_freeSlots[--m_freeCount];
+    m_activeIndex[slot] = m_activeCount;
+    m_activeSlots[m_activeCount++] = slot;
+    m_highWaterMark = std::max(m_highWaterMark, m_activeCount);
+
+    // id的低位就是槽位号，按id查找子弹不用遍历
+    BulletData& bullet = m_pool[slot];
+    bullet.id = m_nextBulletId * MAX_BULLETS + slot;
+    m_nextBulletId = (m_nextBulletId + 1) % (std::numeric_limits<int>::max() / MAX_BULLETS);
     bullet.position = position;
-    bullet.velocity = normalize(direction) * speed;
+    bullet.velocity = velocity;
     bullet.isActive = true;
     bullet.damage = damage;
-
-    m_bullets.append(bullet);
+    // 子弹走直线，生成时就能算出撞墙或出界的时刻，之后每帧只需积分
+    bullet.lifetime = CollisionSystem::instance().computeRectLifetime(bullet.position, bullet.velocity, BULLET_SIZE);
 }
 
 void BulletViewModel::updateBullets(double deltaTime){
-    for(auto& bullet: m_bullets) {
+    for (int i = 0; i < m_activeCount; ++i) {
+        BulletData& bullet = m_pool[m_activeSlots[i]];
         if(bullet.isActive) {
             bullet.position += bullet.velocity * deltaTime;
-            if(bullet.position.x() < 0 || bullet.position.x() > MAP_WIDTH ||
-               bullet.position.y() < 0 || bullet.position.y() > MAP_HEIGHT) {
+            bullet.lifetime -= deltaTime;
+            if(bullet.lifetime <= 0) {
                 bullet.isActive = false;
-            } else if(CollisionSystem::instance().isRectCollidingWithMap(bullet.position, 5)) {
-                bullet.isActive = false; 
             }
         }
     }
     removeBullets();
-    emit bulletsChanged(m_bullets);
+    emit bulletsChanged(getActiveBullets());
 }
 
 void BulletViewModel::removeBullet(int bulletId) {
-    for (int i = 0; i < m_bullets.size(); ++i) {
-        if (m_bullets[i].id == bulletId) {
-            m_bullets[i].isActive = false; 
-            return; 
-        }
+    const BulletData* bullet = findBullet(bulletId);
+    if (bullet) {
+        m_pool[bullet->id % MAX_BULLETS].isActive = false;
     }
 }
 
 void BulletViewModel::removeBullets() {
-    for (int i = 0; i < m_bullets.size(); ++i) {
-        if (m_bullets[i].isActive == false) {
-            m_bullets.removeAt(i);
+    // 倒序回收，交换删除不会漏掉换过来的子弹
+    for (int i = m_activeCount - 1; i >= 0; --i) {
+        if (!m_pool[m_activeSlots[i]].isActive) {
+            releaseSlot(m_activeSlots[i]);
         }
     }
 }
+
+void BulletViewModel::releaseSlot(int slot) {
+    int index = m_activeIndex[slot];
+    int lastSlot = m_activeSlots[--m_activeCount];
+    m_activeSlots[index] = lastSlot;
+    m_activeIndex[lastSlot] = index;
+    m_pool[slot].isActive = false;
+    m_freeSlots[m_freeCount++] = slot;
+}
+
 void BulletViewModel::clearAllBullets(){
-    m_bullets.clear();
-    emit bulletsChanged(m_bullets);
+    m_activeCount = 0;
+    m_freeCount = MAX_BULLETS;
+    for (int i = 0; i < MAX_BULLETS; ++i) {
+        // 倒着压栈，先分配0号槽
+        m_freeSlots[i] = MAX_BULLETS - 1 - i;
+        m_pool[i].isActive = false;
+    }
+    emit bulletsChanged(getActiveBullets());
 }
 
-QList<BulletData> BulletViewModel::getActiveBullets() const{
-    QList<BulletData> activeBullets;
-    for (const auto& bullet : m_bullets) {
+void BulletViewModel::recomputeLifetimes() {
+    for (int i = 0; i < m_activeCount; ++i) {
+        BulletData& bullet = m_pool[m_activeSlots[i]];
         if (bullet.isActive) {
-            activeBullets.append(bullet);
+            bullet.lifetime = CollisionSystem::instance().computeRectLifetime(bullet.position, bullet.velocity, BULLET_SIZE);
         }
     }
-    return activeBullets;
 }
 
 QPointF BulletViewModel::normalize(const QPointF& point) {
@@ -74,24 +110,34 @@ QPointF BulletViewModel::normalize(const QPointF& point) {
     return point;
 }
 
+const BulletData* BulletViewModel::findBullet(int bulletId) const {
+    if (bulletId < 0) {
+        return nullptr;
+    }
+    const BulletData& bullet = m_pool[bulletId % MAX_BULLETS];
+    if (bullet.id != bulletId || !bullet.isActive) {
+        return nullptr;
+    }
+    return &bullet;
+}
+
 int BulletViewModel::getBulletDamage(int bulletId) const {
-    for (const auto& bullet : m_bullets) {
-        if (bullet.id == bulletId) {
-            return bullet.damage;
-        }
+    const BulletData* bullet = findBullet(bulletId);
+    if (bullet) {
+        return bullet->damage;
     }
     return 0; // 如果找不到子弹，返回0
 }
 
 void BulletViewModel::updateBulletDamage(int bulletId, int newDamage) {
-    for (auto& bullet : m_bullets) {
-        if (bullet.id == bulletId) {
-            bullet.damage = newDamage;
-            // 如果伤害值小于等于0，标记子弹为非活动状态
-            if (bullet.damage <= 0) {
-                bullet.isActive = false;
-            }
-            break;
-        }
+    const BulletData* found = findBullet(bulletId);
+    if (!found) {
+        return;
+    }
+    BulletData& bullet = m_pool[bulletId % MAX_BULLETS];
+    bullet.damage = newDamage;
+    // 如果伤害值小于等于0，标记子弹为非活动状态
+    if (bullet.damage <= 0) {
+        bullet.isActive = false;
     }
-}
\ No newline at end of file
+}
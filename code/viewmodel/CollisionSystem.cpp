@@ -3,6 +3,7 @@
 #include "viewmodel/EnemyManager.h"
 #include "viewmodel/BulletViewModel.h"
 #include "common/GameMap.h"
+#include <limits>
 
 CollisionSystem::CollisionSystem(QObject *parent)
     : QObject(parent)
@@ -16,7 +17,7 @@ CollisionSystem& CollisionSystem::instance(){
 
 void CollisionSystem::checkCollisions(const PlayerViewModel& player,
                                     const QList<EnemyData>& enemies,
-                                    const QList<BulletData>& bullets)
+                                    const BulletView& bullets)
 {
     // 检查玩家与敌人的碰撞
     checkPlayerEnemyCollisions(player, enemies);
@@ -47,7 +48,7 @@ void CollisionSystem::checkPlayerEnemyCollisions(const PlayerViewModel& player,
     }
 }
 
-void CollisionSystem::checkBulletEnemyCollisions(const QList<BulletData>& bullets,
+void CollisionSystem::checkBulletEnemyCollisions(const BulletView& bullets,
                                                const QList<EnemyData>& enemies,
                                                int bulletDamage)
 {
@@ -119,6 +120,16 @@ bool CollisionSystem::isPointInWalkableTile(const QPointF& point) const
 
 bool CollisionSystem::isRectCollidingWithMap(const QPointF& position, int size) const
 {
+    // 常用尺寸直接查预计算的通行图
+    const ClearanceMap* clearance = GameMap::instance().getClearanceMap(size);
+    if (clearance) {
+        int px = static_cast<int>(std::floor(position.x()));
+        int py = static_cast<int>(std::floor(position.y()));
+        if (clearance->contains(px, py)) {
+            return !clearance->fits(clearance->indexOf(px, py));
+        }
+    }
+
     int bx = position.x() == static_cast<int>(position.x()) ? 0:size/16;
     int by = position.y() == static_cast<int>(position.y()) ? 0:size/16;
 
@@ -136,3 +147,92 @@ bool CollisionSystem::isRectCollidingWithMap(const QPointF& position, int size)
     }
     return false;
 }
+
+QPointF CollisionSystem::moveRectInMap(const QPointF& position, const QPointF& movement, int size) const
+{
+    QPointF result = position;
+    result.setX(clampAxisMove(result, movement.x(), size, true));
+    result.setY(clampAxisMove(result, movement.y(), size, false));
+    return result;
+}
+
+/*
+    * 沿单个轴移动：查一次通行图得到该方向可连续移动的像素数，再把目标坐标夹到范围内
+    * @return 移动后该轴的坐标
+*/
+double CollisionSystem::clampAxisMove(const QPointF& position, double delta, int size, bool horizontal) const
+{
+    double from = horizontal ? position.x() : position.y();
+    double to = from + delta;
+    if (delta == 0.0) {
+        return from;
+    }
+
+    const ClearanceMap* clearance = GameMap::instance().getClearanceMap(size);
+    int px = static_cast<int>(std::floor(position.x()));
+    int py = static_cast<int>(std::floor(position.y()));
+    if (!clearance || !clearance->contains(px, py) || !clearance->fits(clearance->indexOf(px, py))) {
+        // 没有通行图或当前位置本身放不下：退回逐瓦片检测，整步要么通过要么不动
+        QPointF target = horizontal ? QPointF(to, position.y()) : QPointF(position.x(), to);
+        return isRectCollidingWithMap(target, size) ? from : to;
+    }
+
+    int index = clearance->indexOf(px, py);
+    int base = horizontal ? px : py;
+    if (delta > 0) {
+        int limit = base + (horizontal ? clearance->runRight[index] : clearance->runDown[index]);
+        // 已经贴着障碍物时limit可能小于当前小数坐标，不能往回拉
+        return std::floor(to) > limit ? std::max(from, static_cast<double>(limit)) : to;
+    }
+    int limit = base - (horizontal ? clearance->runLeft[index] : clearance->runUp[index]);
+    return std::floor(to) < limit ? static_cast<double>(limit) : to;
+}
+
+/*
+    * 按瓦片网格做一次射线步进：只在方块前沿跨过瓦片边界时检测新覆盖的瓦片
+    * @return 第一次碰到不可行走瓦片或离开地图的时间，永远碰不到时返回无穷大
+*/
+double CollisionSystem::computeRectLifetime(const QPointF& position, const QPointF& velocity, int size) const
+{
+    // 跨过边界后稍微往前取一点，避免停在边界上反复计算同一个交点
+    const double epsilon = 1e-9;
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double vx = velocity.x();
+    const double vy = velocity.y();
+
+    // 与updateBullets原先的出界判定一致：x<0、x>MAP_WIDTH、y<0、y>MAP_HEIGHT
+    double exitTime = infinity;
+    if (vx < 0) exitTime = std::min(exitTime, position.x() / -vx);
+    if (vx > 0) exitTime = std::min(exitTime, (MAP_WIDTH - position.x()) / vx);
+    if (vy < 0) exitTime = std::min(exitTime, position.y() / -vy);
+    if (vy > 0) exitTime = std::min(exitTime, (MAP_HEIGHT - position.y()) / vy);
+    exitTime = std::max(exitTime, 0.0);
+
+    double t = 0.0;
+    while (t < exitTime) {
+        QPointF p = position + velocity * (t + epsilon);
+        if (isRectCollidingWithMap(p, size)) {
+            return t;
+        }
+        if (vx == 0 && vy == 0) {
+            break;
+        }
+
+        double nextX = infinity;
+        if (vx > 0) {
+            double lead = p.x() + size - 1;
+            nextX = t + ((std::floor(lead / 16) + 1) * 16 - lead) / vx;
+        } else if (vx < 0) {
+            nextX = t + (p.x() - std::floor(p.x() / 16) * 16) / -vx;
+        }
+        double nextY = infinity;
+        if (vy > 0) {
+            double lead = p.y() + size - 1;
+            nextY = t + ((std::floor(lead / 16) + 1) * 16 - lead) / vy;
+        } else if (vy < 0) {
+            nextY = t + (p.y() - std::floor(p.y() / 16) * 16) / -vy;
+        }
+        t = std::max(std::min(nextX, nextY), t + epsilon);
+    }
+    return exitTime;
+}
@@ -178,15 +178,7 @@ void EnemyManager::updateEnemies(double deltaTime, const QPointF& playerPos, boo
             }
             // 只有未部署的刺球怪才更新位置
             if (!(enemy.enemyType == 1 && enemy.isDeployed)) {
-                QPointF new_pos = enemy.position;
-                new_pos.setX(new_pos.x() + enemy.velocity.x() * deltaTime);
-                if(!CollisionSystem::instance().isRectCollidingWithMap(new_pos,16)) {
-                    enemy.position.setX(new_pos.x());
-                }
-                new_pos.setY(new_pos.y() + enemy.velocity.y() * deltaTime);
-                if(!CollisionSystem::instance().isRectCollidingWithMap(new_pos,16)) {
-                    enemy.position.setY(new_pos.y());
-                }
+                enemy.position = CollisionSystem::instance().moveRectInMap(enemy.position, enemy.velocity * deltaTime, 16);
             }
         }
     }
@@ -16,6 +16,7 @@ void GameViewModel::startGame()
     if (m_gameState != GameState::PLAYING) {
         resetGame();
         m_gameState = GameState::PLAYING;
+        prefetchNextArea();
         emit gameStateChanged(m_gameState);
         qDebug() << "Game started";
     }
@@ -49,13 +50,9 @@ void GameViewModel::endGame()
     }
 }
 
-void GameViewModel::nextGame() {
-    m_enemyManager->clearAllEnemies();
-    m_gameTime = 0.0;
-    
-    // 更新当前区域编号
-    int area1 = m_currentArea / 10;  // 地图编号
-    int area2 = m_currentArea % 10;  // 布局编号
+int GameViewModel::followingArea(int area) {
+    int area1 = area / 10;  // 地图编号
+    int area2 = area % 10;  // 布局编号
     
     // 切换到下一个布局
     area2++;
@@ -71,8 +68,24 @@ void GameViewModel::nextGame() {
         area1 = 1;
         area2 = 1;
     }
+    return area1 * 10 + area2;
+}
+
+void GameViewModel::prefetchNextArea() {
+    // 这一波刚开始就在后台准备下一个布局，布局1-2之后是胜利，不用准备
+    int next = followingArea(m_currentArea);
+    if (next == 13) return;
+    m_levelPrefetcher->request(QString("map_%1").arg(next / 10), QString::number(next % 10));
+}
+
+void GameViewModel::nextGame() {
+    m_enemyManager->clearAllEnemies();
+    m_gameTime = 0.0;
     
-    m_currentArea = area1 * 10 + area2;
+    // 更新当前区域编号
+    m_currentArea = followingArea(m_currentArea);
+    int area1 = m_currentArea / 10;  // 地图编号
+    int area2 = m_currentArea % 10;  // 布局编号
     
     // 检查是否是布局1-2结束后（area1=1, area2=3，即map_1的布局3）
     if (area1 == 1 && area2 == 3) {
@@ -89,7 +102,13 @@ void GameViewModel::nextGame() {
     QString mapName = QString("map_%1").arg(area1);
     QString layoutName = QString::number(area2);
     
-    GameMap::instance().loadFromFile(":/assert/picture/gamemap.json", mapName, layoutName);
+    // 正常情况下后台已经准备好，这里只是换一份数据
+    PreparedLevel level = m_levelPrefetcher->take(mapName, layoutName);
+    if (level.layout) {
+        GameMap::instance() = level.simMap;
+    }
+    // 子弹寿命是按旧布局算的，换布局后要重算
+    m_player->getBulletViewModel()->recomputeLifetimes();
     
     // 只在切换到不同地图或布局2结束后重置供应商状态
     if (area1 > 1 || (area1 == 1 && area2 > 2)) {
@@ -97,7 +116,8 @@ void GameViewModel::nextGame() {
         m_vendorManager->hideVendor();
     }
     
-    emit mapChanged();
+    emit mapChanged(level.layout);
+    prefetchNextArea();
 }
 
 void GameViewModel::manualNextGame() {
@@ -278,6 +298,7 @@ void GameViewModel::initializeComponents()
     m_collisionSystem = std::make_unique<CollisionSystem>(this);
     m_itemEffectManager = std::make_unique<ItemEffectManager>(this);
     m_vendorManager = std::make_unique<VendorManager>(this);
+    m_levelPrefetcher = std::make_unique<LevelPrefetcher>();
 }
 
 void GameViewModel::resetGame()
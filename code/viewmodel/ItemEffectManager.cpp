@@ -1,6 +1,7 @@
 #include "viewmodel/ItemEffectManager.h"
 #include "viewmodel/PlayerViewModel.h"
 #include "viewmodel/EnemyManager.h"
+#include "viewmodel/ItemCatalog.h"
 #include <algorithm>
 
 ItemEffectManager::ItemEffectManager(QObject *parent)
@@ -88,73 +89,13 @@ void ItemEffectManager::applyItemEffect(int itemType, PlayerViewModel* player, E
 
 //转换成中文这样debug信息清楚一点
 QString ItemEffectManager::getItemName(int itemType) {
-    switch(itemType) {
-        case coin: return "1 Coin";
-        case five_coins: return "5 Coin";
-        case extra_life: return "额外生命";
-        case coffee: return "咖啡";
-        case machine_gun: return "重机枪";
-        case bomb: return "清屏核弹";
-        case shotgun: return "霰弹枪";
-        case smoke_bomb: return "烟雾弹";
-        case tombstone: return "墓碑";
-        case wheel: return "轮子";
-        case badge: return "治安官徽章";
-        
-        // 供应商道具名称
-        case vendor_boots_1:
-        case vendor_boots_2:
-            return "靴子";
-        case vendor_extra_life:
-            return "额外生命";
-        case vendor_gun_1:
-        case vendor_gun_2:
-        case vendor_gun_3:
-            return "枪";
-        case vendor_ammo_1:
-        case vendor_ammo_2:
-        case vendor_ammo_3:
-            return "弹药";
-        case vendor_badge:
-            return "治安官徽章";
-        
-        default: return "未知道具";
-    }
+    const ItemCatalog::ItemInfo* info = ItemCatalog::find(itemType);
+    return info ? QString::fromUtf8(info->name) : QString("未知道具");
 }
 
 QString ItemEffectManager::getItemDescription(int itemType) {
-    switch(itemType) {
-        case coin: return "增加1个硬币数量";
-        case five_coins: return "增加5个硬币数量";
-        case extra_life: return "你的总生命值加一";
-        case coffee: return "增加你的移动速率";
-        case machine_gun: return "大幅增加开火速率";
-        case bomb: return "瞬间摧毁所有屏幕上的敌人";
-        case shotgun: return "每次射击会朝开火方向射出三枚方向呈锥状分散的子弹";
-        case smoke_bomb: return "将你的角色传送至屏幕上随机地点并赋予潜行";
-        case tombstone: return "一道闪电击中你的角色，在一定时间内将你转变成僵尸";
-        case wheel: return "你可以一次对8个方向射出子弹";
-        case badge: return "提高开火速率和移动速率，并使你能像使用霰弹枪那样锥状射击";
-        
-        // 供应商道具描述
-        case vendor_boots_1:
-        case vendor_boots_2:
-            return "提高移动速度";
-        case vendor_extra_life:
-            return "获得额外一条生命，当供应商下一次出现的时候，可以再次购买";
-        case vendor_gun_1:
-        case vendor_gun_2:
-        case vendor_gun_3:
-            return "提高射击速度";
-        case vendor_ammo_1:
-        case vendor_ammo_2:
-        case vendor_ammo_3:
-            return "把子弹的杀伤值提高到2/3/4。子弹具有穿透性";
-        case vendor_badge:
-            return "获得一枚治安官徽章，当供应商下一次出现的时候，可以再次购买";
-        
-        default: return "未知效果";
-    }
+    const ItemCatalog::ItemInfo* info = ItemCatalog::find(itemType);
+    return info ? QString::fromUtf8(info->description) : QString("未知效果");
 }
 
 void ItemEffectManager::applyCoinEffect(PlayerViewModel* player, EnemyManager* enemyManager, bool isImmediate) {
@@ -303,18 +244,20 @@ void ItemEffectManager::addEffect(EffectType type, double duration, double origi
     double endTime = m_currentTime + duration;
     ItemEffect effect(type, endTime, originalValue, effectValue);
     m_activeEffects[type] = effect;
+    m_effectTimers.schedule(type, TimerWheel::expiryTickFor(endTime));
     qDebug() << "添加效果:" << type << "持续时间:" << duration << "秒";
 }
 
 void ItemEffectManager::removeEffect(EffectType type) {
-    if (m_activeEffects.contains(type)) {
-        m_activeEffects.remove(type);
+    if (m_activeEffects[type].isActive) {
+        m_activeEffects[type].isActive = false;
+        m_effectTimers.cancel(type);
         qDebug() << "移除效果:" << type;
     }
 }
 
 bool ItemEffectManager::hasEffect(EffectType type) const {
-    return m_activeEffects.contains(type) && m_activeEffects[type].isActive;
+    return m_activeEffects[type].isActive;
 }
 
 double ItemEffectManager::getEffectRemainingTime(EffectType type) const {
@@ -325,16 +268,9 @@ double ItemEffectManager::getEffectRemainingTime(EffectType type) const {
 }
 
 double ItemEffectManager::getItemEffectDuration(int itemType) {
-    switch(itemType) {
-        case coffee: return 10.0;        // 咖啡效果持续10秒
-        case machine_gun: return 8.0;    // 机枪效果持续8秒
-        case wheel: return 12.0;         // 轮子效果持续12秒
-        case shotgun: return 10.0;       // 霰弹枪效果持续10秒
-        case badge: return 15.0;         // 治安官徽章效果持续15秒
-        case smoke_bomb: return 5.0;     // 烟雾弹效果持续5秒
-        case tombstone: return 8.0;      // 墓碑效果持续8秒
-        default: return 0.0;             // 其他道具无持续时间
-    }
+    // 其他道具无持续时间
+    const ItemCatalog::ItemInfo* info = ItemCatalog::find(itemType);
+    return info ? info->effectDuration : 0.0;
 }
 
 void ItemEffectManager::applyEffectToPlayer(EffectType type, double effectValue, PlayerViewModel* player) {
@@ -402,15 +338,17 @@ void ItemEffectManager::restorePlayerFromEffect(EffectType type, double original
 }
 
 void ItemEffectManager::checkAndRemoveExpiredEffects(double currentTime, PlayerViewModel* player) {
-    QVector<EffectType> expiredEffects;
-    
-    for (auto it = m_activeEffects.begin(); it != m_activeEffects.end(); ++it) {
-        if (it.value().isActive && currentTime >= it.value().endTime) {
-            expiredEffects.append(it.key());
-        }
+    // 时间轮只返回真正到期的效果，没有到期的一个都不碰
+    m_expiredEffects.clear();
+    m_effectTimers.advanceTo(TimerWheel::tickAt(currentTime), m_expiredEffects);
+    if (m_expiredEffects.isEmpty()) {
+        return;
     }
-    
-    for (EffectType type : expiredEffects) {
+    // 同一帧到期的多个效果按类型顺序恢复，和原先遍历QMap的顺序一致
+    std::sort(m_expiredEffects.begin(), m_expiredEffects.end());
+
+    for (int key : m_expiredEffects) {
+        EffectType type = static_cast<EffectType>(key);
         ItemEffect& effect = m_activeEffects[type];
         effect.isActive = false;
         restorePlayerFromEffect(type, effect.originalValue, player);
@@ -421,28 +359,24 @@ void ItemEffectManager::checkAndRemoveExpiredEffects(double currentTime, PlayerV
         
         qDebug() << "效果过期:" << type;
     }
-    
-    // 清理过期的效果
-    for (EffectType type : expiredEffects) {
-        m_activeEffects.remove(type);
-    }
 }
 
 void ItemEffectManager::clearAllEffects(PlayerViewModel* player) {
     // 恢复所有效果到原始状态，但不重置供应商的永久效果
-    for (auto it = m_activeEffects.begin(); it != m_activeEffects.end(); ++it) {
-        if (player) {
+    for (ItemEffect& effect : m_activeEffects) {
+        if (effect.isActive && player) {
             // 不重置供应商的永久效果（BADGE_MODE, 移动速度, 射击速度等）
             // 这些效果应该在整个游戏过程中保持
-            EffectType type = it.key();
+            EffectType type = effect.type;
             if (type != BADGE_MODE) { // 不重置治安官徽章模式
-                restorePlayerFromEffect(type, it.value().originalValue, player);
+                restorePlayerFromEffect(type, effect.originalValue, player);
             }
         }
+        // 清空所有效果
+        effect.isActive = false;
     }
     
-    // 清空所有效果
-    m_activeEffects.clear();
+    m_effectTimers.clear();
     m_currentTime = 0.0;
     
     qDebug() << "清除所有道具效果（保留供应商永久效果）";
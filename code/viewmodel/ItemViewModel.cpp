@@ -8,19 +8,12 @@ ItemViewModel::ItemViewModel(QObject *parent)
     : QObject(parent) {
 }
 
-void ItemViewModel::createItem(const QPointF& position, QMap<int, double> itemPossibilities) {
-    double randomValue = static_cast<double>(rand()) / RAND_MAX; 
-    double cumulativeProbability = 0.0;
-    
-    for (auto it = itemPossibilities.constBegin(); it != itemPossibilities.constEnd(); ++it) {
-        cumulativeProbability += it.value();
-        if (randomValue <= cumulativeProbability) {
-            createItem(position, it.key());
-            return; 
-        }
+void ItemViewModel::createItem(const QPointF& position, const ItemCatalog::DropTable& dropTable) {
+    if (dropTable.count == 0) {
+        createItem(position, ItemEffectManager::coin);
+        return;
     }
-
-    createItem(position, ItemEffectManager::coin); 
+    createItem(position, ItemCatalog::sampleDrop(dropTable, QRandomGenerator::global()));
 }
 
 void ItemViewModel::createItem(const QPointF& position, int type) {
@@ -36,18 +29,23 @@ void ItemViewModel::createItem(const QPointF& position, int type) {
     newItem.position = {px, py};
     newItem.isPossessed = false;
     newItem.isActive = true;
-    newItem.remainTime = 15.0; 
+    newItem.expireTime = m_itemTime + ITEM_LIFETIME; 
+    m_expiryTimers.schedule(newItem.id, TimerWheel::expiryTickFor(newItem.expireTime));
     // 道具生成完成
     m_items.append(newItem);
     m_itemPositions[positionPair] = newItem.id;
 }
 
 void ItemViewModel::updateItems(double deltaTime, const QPointF& playerPosition) {
-    for (auto& item : m_items) {
-        if (item.isActive) {
-            item.remainTime -= deltaTime;
-            if (item.remainTime <= 0.0) {
-                item.isActive = false; 
+    // 只处理这一帧到期的道具
+    m_itemTime += deltaTime;
+    m_expiredItems.clear();
+    m_expiryTimers.advanceTo(TimerWheel::tickAt(m_itemTime), m_expiredItems);
+    for (int id : m_expiredItems) {
+        for (auto& item : m_items) {
+            if (item.id == id) {
+                item.isActive = false;
+                break;
             }
         }
     }
@@ -62,6 +60,7 @@ void ItemViewModel::updateItems(double deltaTime, const QPointF& playerPosition)
         if (distance <= 8.0) {
             ItemData pickedItem = item;
             item.isActive = false; // 标记道具为已拾取
+            m_expiryTimers.cancel(item.id);
             
             // 检查是否为需要立即使用的道具类型
             bool shouldUseImmediately = (pickedItem.type == ItemEffectManager::coin || 
@@ -97,23 +96,15 @@ void ItemViewModel::updateItems(double deltaTime, const QPointF& playerPosition)
                                   [](const ItemData& item) { return !item.isActive; }),
                   m_items.end());
 
-    emit itemsChanged(m_items); // 发出道具列表变化信号
+    emit itemsChanged(getActiveItems(), m_itemTime); // 发出道具列表变化信号
     emit possessedItemChanged(m_possessedItem.type, m_possessingItem); // 发出道具栏变化信号
 }
 
-QList<ItemData> ItemViewModel::getActiveItems() const {
-    QList<ItemData> activeItems;
-    for (const auto& item : m_items) {
-        if (item.isActive) {
-            activeItems.append(item);
-        }
-    }
-    return activeItems;
-}
-
 void ItemViewModel::clearAllItems() {
     m_items.clear();
     m_nextItemId = 0; 
+    m_expiryTimers.clear();
+    m_itemTime = 0.0;
     m_itemPositions.clear();
     m_possessingItem = false;
 }
@@ -151,20 +142,6 @@ void ItemViewModel::spawnItemAtPosition(const QPointF& position) {
 }
 
 int ItemViewModel::selectRandomItemType() const {
-    // 平衡的道具生成概率分布
-    int randomValue = QRandomGenerator::global()->bounded(100);
-    
-    if (randomValue < 10) return ItemEffectManager::coin;           // 10% 金币
-    if (randomValue < 40) return ItemEffectManager::five_coins;     // 30% 五金币
-    if (randomValue < 50) return ItemEffectManager::extra_life;     // 10% 额外生命
-    if (randomValue < 60) return ItemEffectManager::coffee;         // 10% 咖啡
-    if (randomValue < 68) return ItemEffectManager::machine_gun;    // 8% 机枪
-    if (randomValue < 75) return ItemEffectManager::bomb;           // 7% 清屏核弹
-    if (randomValue < 82) return ItemEffectManager::shotgun;        // 7% 霰弹枪
-    if (randomValue < 88) return ItemEffectManager::smoke_bomb;     // 6% 烟雾弹
-    if (randomValue < 93) return ItemEffectManager::tombstone;      // 5% 墓碑
-    if (randomValue < 97) return ItemEffectManager::wheel;          // 4% 轮子
-    if (randomValue < 100) return ItemEffectManager::badge;         // 3% 治安官徽章
-    
-    return ItemEffectManager::coin; // 默认返回金币
-}
\ No newline at end of file
+    // 掉落概率见ItemCatalog的dropWeight
+    return ItemCatalog::sampleDrop(ItemCatalog::DROP_TABLE, QRandomGenerator::global());
+}
@@ -0,0 +1,51 @@
+#include "viewmodel/LevelPrefetcher.h"
+#include <QDebug>
+
+LevelPrefetcher::LevelPrefetcher(QObject *parent)
+    : QObject(parent) {
+    m_worker = new QObject();
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.start(QThread::LowPriority);
+}
+
+LevelPrefetcher::~LevelPrefetcher() {
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void LevelPrefetcher::request(const QString& mapName, const QString& layoutName) {
+    int generation = ++m_generation;
+    m_hasReady = false;
+    m_ready = PreparedLevel();
+    QMetaObject::invokeMethod(m_worker, [this, generation, mapName, layoutName]() {
+        // 工作线程里只读关卡目录，不碰其它单例，结果排队送回GUI线程
+        PreparedLevel level = prepare(mapName, layoutName);
+        QMetaObject::invokeMethod(this, [this, generation, level]() {
+            if (generation != m_generation) return;
+            m_ready = level;
+            m_hasReady = true;
+        });
+    });
+}
+
+PreparedLevel LevelPrefetcher::take(const QString& mapName, const QString& layoutName) {
+    if (m_hasReady && m_ready.layout && m_ready.layout->mapName == mapName && m_ready.layout->layoutName == layoutName) {
+        m_hasReady = false;
+        PreparedLevel level = m_ready;
+        m_ready = PreparedLevel();
+        return level;
+    }
+    // 预取还没完成或者取的不是预取的布局，作废正在进行的请求，当场加载
+    qDebug() << "[LevelPrefetcher] 预取未命中，同步加载" << mapName << layoutName;
+    ++m_generation;
+    m_hasReady = false;
+    return prepare(mapName, layoutName);
+}
+
+PreparedLevel LevelPrefetcher::prepare(const QString& mapName, const QString& layoutName) {
+    PreparedLevel level;
+    level.layout = LevelCatalog::instance().layout(mapName, layoutName);
+    level.simMap.setLayout(level.layout);
+    return level;
+}
@@ -1,6 +1,7 @@
 #include "viewmodel/PlayerViewModel.h"
 #include "common/GameMap.h"
 #include "viewmodel/CollisionSystem.h"
+#include "viewmodel/ShotPatterns.h"
 #include <QVector>
 #include <QRandomGenerator>
 #include <QDebug>
@@ -19,12 +20,7 @@ void PlayerViewModel::move(double deltaTime)
     if(m_stats.moving)
         movement= m_stats.movingDirection * m_stats.moveSpeed * deltaTime;
 
-    if(!CollisionSystem::instance().isRectCollidingWithMap(QPointF(orig_pos.x() + movement.x(), orig_pos.y()), 14)) {
-        m_stats.position.setX(orig_pos.x() + movement.x());
-    } 
-    if(!CollisionSystem::instance().isRectCollidingWithMap(QPointF(orig_pos.x(), orig_pos.y() + movement.y()), 14)) {
-        m_stats.position.setY(orig_pos.y() + movement.y());
-    }
+    m_stats.position = CollisionSystem::instance().moveRectInMap(orig_pos, movement, 14);
     
     m_stats.position.setX(std::clamp(m_stats.position.x(), 16.0, static_cast<double>(MAP_WIDTH)-32.0));
     m_stats.position.setY(std::clamp(m_stats.position.y(), 16.0, static_cast<double>(MAP_HEIGHT)-32.0));
@@ -52,7 +48,12 @@ void PlayerViewModel::shoot(const QPointF& direction)
             shootInShotgunPattern(direction);
         } else {
             // 正常射击模式：只向指定方向发射一颗子弹
-            m_bulletViewModel->createBullet(m_stats.position, direction, 170, m_stats.bulletDamage);
+            int index = ShotPatterns::compassIndex(direction.x(), direction.y());
+            if (index >= 0) {
+                m_bulletViewModel->createBullets(m_stats.position, &ShotPatterns::SINGLE[index], 1, 170, m_stats.bulletDamage);
+            } else {
+                m_bulletViewModel->createBullet(m_stats.position, direction, 170, m_stats.bulletDamage);
+            }
         }
         
         m_currentShootCooldown = m_stats.shootCooldown;
@@ -122,92 +123,37 @@ void PlayerViewModel::updateShootCooldown(double deltaTime)
 void PlayerViewModel::shootInEightDirections()
 {
     // 8个方向：上、右上、右、右下、下、左下、左、左上
-    QVector<QPointF> directions = {
-        QPointF(0, -1),    // 上
-        QPointF(1, -1),    // 右上
-        QPointF(1, 0),     // 右
-        QPointF(1, 1),     // 右下
-        QPointF(0, 1),     // 下
-        QPointF(-1, 1),    // 左下
-        QPointF(-1, 0),    // 左
-        QPointF(-1, -1)    // 左上
-    };
-    
-    // 向8个方向发射子弹
-    for (const auto& direction : directions) {
-        m_bulletViewModel->createBullet(m_stats.position, direction, 170, m_stats.bulletDamage);
-    }
-    
-    qDebug() << "8方向射击：向8个方向发射子弹";
+    m_bulletViewModel->createBullets(m_stats.position, ShotPatterns::WHEEL, ShotPatterns::WHEEL_COUNT,
+                                     170, m_stats.bulletDamage);
 }
 
 void PlayerViewModel::shootInShotgunPattern(const QPointF& direction)
 {
     // 霰弹枪模式：向指定方向及其左右30度发射子弹
-    QVector<QPointF> directions;
-    
-    // 计算角度（以弧度为单位）
+    int index = ShotPatterns::compassIndex(direction.x(), direction.y());
+    if (index >= 0) {
+        m_bulletViewModel->createBullets(m_stats.position, ShotPatterns::SHOTGUN[index], ShotPatterns::SHOTGUN_COUNT,
+                                         170, m_stats.bulletDamage);
+        return;
+    }
+
+    // 不是方向键组合的方向查不到表，现算三个方向
     double angle = std::atan2(direction.y(), direction.x());
     double angleOffset = M_PI / 6.0; // 30度 = π/6弧度
-    
-    // 计算三个方向：左30度、中心、右30度
-    double leftAngle = angle - angleOffset;
-    double centerAngle = angle;
-    double rightAngle = angle + angleOffset;
-    
-    // 转换为单位向量
-    QPointF leftDir(std::cos(leftAngle), std::sin(leftAngle));
-    QPointF centerDir(std::cos(centerAngle), std::sin(centerAngle));
-    QPointF rightDir(std::cos(rightAngle), std::sin(rightAngle));
-    
-    directions = {leftDir, centerDir, rightDir};
-    
-    // 向确定的方向发射子弹
-    for (const auto& dir : directions) {
-        m_bulletViewModel->createBullet(m_stats.position, dir, 170, m_stats.bulletDamage);
-    }
-    
-    qDebug() << "霰弹枪射击：向" << directions.size() << "个方向发射子弹";
+    QPointF directions[ShotPatterns::SHOTGUN_COUNT] = {
+        QPointF(std::cos(angle - angleOffset), std::sin(angle - angleOffset)),
+        QPointF(std::cos(angle), std::sin(angle)),
+        QPointF(std::cos(angle + angleOffset), std::sin(angle + angleOffset))
+    };
+    m_bulletViewModel->createBullets(m_stats.position, directions, ShotPatterns::SHOTGUN_COUNT,
+                                     170, m_stats.bulletDamage);
 }
 
 void PlayerViewModel::shootInWheelShotgunCombination()
 {
-    // 轮子+霰弹枪组合模式：向8个方向发射霰弹枪子弹
-    // 8个方向：上、右上、右、右下、下、左下、左、左上
-    QVector<QPointF> directions = {
-        QPointF(0, -1),    // 上
-        QPointF(1, -1),    // 右上
-        QPointF(1, 0),     // 右
-        QPointF(1, 1),     // 右下
-        QPointF(0, 1),     // 下
-        QPointF(-1, 1),    // 左下
-        QPointF(-1, 0),    // 左
-        QPointF(-1, -1)    // 左上
-    };
-    
-    // 对每个方向应用霰弹枪模式
-    for (const auto& mainDirection : directions) {
-        // 计算角度（以弧度为单位）
-        double angle = std::atan2(mainDirection.y(), mainDirection.x());
-        double angleOffset = M_PI / 6.0; // 30度 = π/6弧度
-        
-        // 计算三个方向：左30度、中心、右30度
-        double leftAngle = angle - angleOffset;
-        double centerAngle = angle;
-        double rightAngle = angle + angleOffset;
-        
-        // 转换为单位向量
-        QPointF leftDir(std::cos(leftAngle), std::sin(leftAngle));
-        QPointF centerDir(std::cos(centerAngle), std::sin(centerAngle));
-        QPointF rightDir(std::cos(rightAngle), std::sin(rightAngle));
-        
-        // 向三个方向发射子弹
-        m_bulletViewModel->createBullet(m_stats.position, leftDir, 170, m_stats.bulletDamage);
-        m_bulletViewModel->createBullet(m_stats.position, centerDir, 170, m_stats.bulletDamage);
-        m_bulletViewModel->createBullet(m_stats.position, rightDir, 170, m_stats.bulletDamage);
-    }
-    
-    qDebug() << "轮子+霰弹枪组合射击：向8个方向发射霰弹枪模式子弹，总共" << (8 * 3) << "颗子弹";
+    // 轮子+霰弹枪组合模式：向8个方向发射霰弹枪子弹，共24颗
+    m_bulletViewModel->createBullets(m_stats.position, ShotPatterns::WHEEL_SHOTGUN, ShotPatterns::WHEEL_SHOTGUN_COUNT,
+                                     170, m_stats.bulletDamage);
 }
 
 void PlayerViewModel::teleportToRandomPosition()
@@ -1,6 +1,7 @@
 #include "viewmodel/VendorManager.h"
 #include "viewmodel/PlayerViewModel.h"
 #include "viewmodel/ItemEffectManager.h"
+#include "viewmodel/ItemCatalog.h"
 #include <QDebug>
 
 VendorManager::VendorManager(QObject *parent)
@@ -122,23 +123,28 @@ void VendorManager::initializeVendorItems() {
     m_vendorItems.clear();
     // 重置所有槽位进度
     for (int i = 0; i < 4; i++) m_slotProgress[i] = 0;
+    // 价格见ItemCatalog的vendorPrice
     // 槽位0：靴子系列 + 额外生命
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_boots_1, 2, 0, 0));   // 靴子1 - 2金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_boots_2, 5, 0, 1));   // 靴子2 - 5金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_extra_life, 3, 0, 2, false, true)); // 额外生命 - 3金币，无限购买
+    addVendorItem(ItemEffectManager::vendor_boots_1, 0, 0);
+    addVendorItem(ItemEffectManager::vendor_boots_2, 0, 1);
+    addVendorItem(ItemEffectManager::vendor_extra_life, 0, 2, true); // 无限购买
     // 槽位1：枪系列 + 徽章
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_gun_1, 3, 1, 0));    // 枪1 - 3金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_gun_2, 6, 1, 1));    // 枪2 - 6金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_gun_3, 10, 1, 2));   // 枪3 - 10金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_badge, 3, 1, 3, false, true)); // 治安官徽章 - 3金币，无限购买
+    addVendorItem(ItemEffectManager::vendor_gun_1, 1, 0);
+    addVendorItem(ItemEffectManager::vendor_gun_2, 1, 1);
+    addVendorItem(ItemEffectManager::vendor_gun_3, 1, 2);
+    addVendorItem(ItemEffectManager::vendor_badge, 1, 3, true);      // 无限购买
     // 槽位2：弹药系列 + 徽章
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_ammo_1, 5, 2, 0));   // 弹药1 - 5金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_ammo_2, 8, 2, 1));   // 弹药2 - 8金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_ammo_3, 12, 2, 2));  // 弹药3 - 12金币
-    m_vendorItems.append(VendorItemConfig(ItemEffectManager::vendor_badge, 3, 2, 3, false, true)); // 治安官徽章 - 3金币，无限购买
+    addVendorItem(ItemEffectManager::vendor_ammo_1, 2, 0);
+    addVendorItem(ItemEffectManager::vendor_ammo_2, 2, 1);
+    addVendorItem(ItemEffectManager::vendor_ammo_3, 2, 2);
+    addVendorItem(ItemEffectManager::vendor_badge, 2, 3, true);      // 无限购买
     qDebug() << "[供应商初始化] 槽位进度: [0]" << m_slotProgress[0] << "[1]" << m_slotProgress[1] << "[2]" << m_slotProgress[2];
 }
 
+void VendorManager::addVendorItem(int itemType, int slotIndex, int itemIndex, bool isInfinitePurchase) {
+    m_vendorItems.append(VendorItemConfig(itemType, getItemPrice(itemType), slotIndex, itemIndex, false, isInfinitePurchase));
+}
+
 void VendorManager::unlockNextItem(int slotIndex) {
     if (slotIndex < 0 || slotIndex >= 4) {
         return;
@@ -157,12 +163,8 @@ void VendorManager::unlockNextItem(int slotIndex) {
 }
 
 int VendorManager::getItemPrice(int itemType) const {
-    for (const auto& item : m_vendorItems) {
-        if (item.itemType == itemType) {
-            return item.price;
-        }
-    }
-    return 0;
+    const ItemCatalog::ItemInfo* info = ItemCatalog::find(itemType);
+    return info ? info->vendorPrice : 0;
 }
 
 int VendorManager::getSlotIndex(int itemType) const {